@@ -0,0 +1,1015 @@
+/**
+ * implement a container like std::map in a B+ tree
+ */
+#ifndef SJTU_BTREE_MAP_HPP
+#define SJTU_BTREE_MAP_HPP
+
+// only for std::less<T>
+#include <functional>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu
+{
+
+/**
+ * an ordered map with the interface of sjtu::map, kept in a B+ tree.
+ * a node holds many keys in one array, so a lookup reads O(log_B n) nodes instead of
+ *   O(log n) scattered tree nodes, and the elements live in a linked list of leaves.
+ * the keys of a node are searched by counting the ones less than the target without
+ *   branching on the result, which the compiler can vectorize for arithmetic keys.
+ * unlike sjtu::map, insert and erase move elements between slots,
+ *   so they invalidate every iterator of the map.
+ * an inner node also counts the elements under it, for nth, rank and iterator distance.
+ * the nodes are obtained from Allocator (rebound to the node types).
+ */
+template<class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<pair<const Key, T> > >
+class btree_map
+{
+public:
+	typedef pair<const Key, T> value_type;
+	class iterator;
+	class const_iterator;
+private:
+	//about 256 bytes of elements per leaf and of keys per inner node, at least 8 of them
+	static const size_t leafSize = sizeof(value_type) * 8 > 256 ? 8 : 256 / sizeof(value_type);
+	static const size_t innerSize = sizeof(Key) * 8 > 256 ? 8 : 256 / sizeof(Key);
+	/**
+	 * cnt is the number of elements of a leaf, or the number of keys of an inner node,
+	 *   which has cnt + 1 children.
+	 * every node but the root keeps at least half of its capacity.
+	 * both arrays have one spare slot, so a node is filled first and split afterwards.
+	 */
+	struct node
+	{
+		size_t cnt;
+		bool isLeaf;
+		node(bool _isLeaf) : cnt(0), isLeaf(_isLeaf) {}
+	};
+	struct leaf : node
+	{
+		leaf *prv, *nxt;
+		typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type data[leafSize + 1];
+		leaf() : node(1), prv(nullptr), nxt(nullptr) {}
+		value_type *at(size_t i)
+		{
+			return reinterpret_cast<value_type*>(data + i);
+		}
+	};
+	/**
+	 * key(i) separates ch[i] and ch[i + 1]:
+	 *   every key in ch[i] is less than it, and every key in ch[i + 1] is not.
+	 */
+	struct inner : node
+	{
+		typename std::aligned_storage<sizeof(Key), alignof(Key)>::type keys[innerSize + 1];
+		node *ch[innerSize + 2];
+		size_t total;
+		inner() : node(0), total(0) {}
+		Key *key(size_t i)
+		{
+			return reinterpret_cast<Key*>(keys + i);
+		}
+	};
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<leaf> leaf_allocator;
+	typedef std::allocator_traits<leaf_allocator> leaf_traits;
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<inner> inner_allocator;
+	typedef std::allocator_traits<inner_allocator> inner_traits;
+
+	node *root;
+	//the first and the last leaf, nullptr if empty
+	leaf *head, *tail;
+	size_t dataSize;
+	Compare cc;
+	leaf_allocator leafAlloc;
+	inner_allocator innerAlloc;
+
+	leaf *newLeaf()
+	{
+		return new(leaf_traits::allocate(leafAlloc, 1)) leaf();
+	}
+	inner *newInner()
+	{
+		return new(inner_traits::allocate(innerAlloc, 1)) inner();
+	}
+	//the elements or keys of x should have been destroyed
+	void dispose(node *x)
+	{
+		if (x->isLeaf)
+			leaf_traits::deallocate(leafAlloc, static_cast<leaf*>(x), 1);
+		else
+			inner_traits::deallocate(innerAlloc, static_cast<inner*>(x), 1);
+	}
+	static void moveValue(value_type *dst, value_type *src)
+	{
+		new(dst) value_type(std::move(*src));
+		src->~value_type();
+	}
+	static void moveKey(Key *dst, Key *src)
+	{
+		new(dst) Key(std::move(*src));
+		src->~Key();
+	}
+	static size_t minSize(node *x)
+	{
+		return x->isLeaf ? leafSize / 2 : innerSize / 2;
+	}
+	//the child of x to descend into for key: the number of keys of x not greater than key
+	size_t childOf(inner *x, const Key &key) const
+	{
+		size_t ret = 0;
+		for (size_t i = 0; i < x->cnt; ++i)
+			ret += !cc(key, *x->key(i));
+		return ret;
+	}
+	//the number of elements of x whose key is less than key
+	size_t lowerOf(leaf *x, const Key &key) const
+	{
+		size_t ret = 0;
+		for (size_t i = 0; i < x->cnt; ++i)
+			ret += cc(x->at(i)->first, key);
+		return ret;
+	}
+	//the leaf where key is or should be, the tree should not be empty
+	leaf *descend(const Key &key) const
+	{
+		node *x = root;
+		while (!x->isLeaf)
+			x = static_cast<inner*>(x)->ch[childOf(static_cast<inner*>(x), key)];
+		return static_cast<leaf*>(x);
+	}
+	/**
+	 * the inner nodes from the root down to a leaf, and the child taken in each.
+	 * a node has at least innerSize / 2 + 1 >= 5 children, so 64 levels are enough.
+	 */
+	struct path
+	{
+		inner *x[64];
+		size_t c[64];
+		size_t depth;
+	};
+	/**
+	 * the position of key, or where it should be inserted, and the way to it in p.
+	 * return whether key exists. lf is nullptr if the tree is empty.
+	 */
+	bool seek(const Key &key, path &p, leaf *&lf, size_t &ind) const
+	{
+		p.depth = 0;
+		lf = nullptr;
+		ind = 0;
+		if (root == nullptr)
+			return 0;
+		node *x = root;
+		while (!x->isLeaf)
+		{
+			inner *y = static_cast<inner*>(x);
+			size_t c = childOf(y, key);
+			p.x[p.depth] = y;
+			p.c[p.depth++] = c;
+			x = y->ch[c];
+		}
+		lf = static_cast<leaf*>(x);
+		ind = lowerOf(lf, key);
+		return ind < lf->cnt && !cc(key, lf->at(ind)->first);
+	}
+	static size_t sizeOf(node *x)
+	{
+		return x->isLeaf ? x->cnt : static_cast<inner*>(x)->total;
+	}
+	//the number of elements whose key is less than key
+	size_t rankOf(const Key &key) const
+	{
+		if (root == nullptr)
+			return 0;
+		size_t ret = 0;
+		node *x = root;
+		while (!x->isLeaf)
+		{
+			inner *y = static_cast<inner*>(x);
+			size_t c = childOf(y, key);
+			for (size_t i = 0; i < c; ++i)
+				ret += sizeOf(y->ch[i]);
+			x = y->ch[c];
+		}
+		return ret + lowerOf(static_cast<leaf*>(x), key);
+	}
+	//the index of the element at (lf, ind), dataSize for end()
+	size_t order(leaf *lf, size_t ind) const
+	{
+		return lf == nullptr ? dataSize : rankOf(lf->at(ind)->first);
+	}
+	//the position of the k-th element, throw index_out_of_bound if k >= dataSize
+	void select(size_t k, leaf *&lf, size_t &ind) const
+	{
+		if (k >= dataSize)
+			throw index_out_of_bound();
+		node *x = root;
+		while (!x->isLeaf)
+		{
+			inner *y = static_cast<inner*>(x);
+			size_t i = 0;
+			for (; k >= sizeOf(y->ch[i]); ++i)
+				k -= sizeOf(y->ch[i]);
+			x = y->ch[i];
+		}
+		lf = static_cast<leaf*>(x);
+		ind = k;
+	}
+	//the position of key, lf is nullptr if key does not exist
+	void locate(const Key &key, leaf *&lf, size_t &ind) const
+	{
+		lf = nullptr;
+		if (root == nullptr)
+			return;
+		leaf *x = descend(key);
+		ind = lowerOf(x, key);
+		if (ind < x->cnt && !cc(key, x->at(ind)->first))
+			lf = x;
+	}
+	//the first position whose key is not less than key (greater than key if upper)
+	void bound(const Key &key, bool upper, leaf *&lf, size_t &ind) const
+	{
+		lf = nullptr;
+		if (root == nullptr)
+			return;
+		lf = descend(key);
+		ind = lowerOf(lf, key);
+		if (upper && ind < lf->cnt && !cc(key, lf->at(ind)->first))
+			++ind;
+		//every key of the next leaf is not less than key
+		if (ind == lf->cnt)
+		{
+			lf = lf->nxt;
+			ind = 0;
+		}
+	}
+	static const Key & firstKey(node *x)
+	{
+		while (!x->isLeaf)
+			x = static_cast<inner*>(x)->ch[0];
+		return static_cast<leaf*>(x)->at(0)->first;
+	}
+	/**
+	 * construct value_type(args...) at index ind of lf, which is the end of p (found by seek),
+	 *   then split the nodes on p which became full, from the bottom up.
+	 * return an iterator to the new element.
+	 */
+	template<class... Args>
+	iterator putAt(path &p, leaf *lf, size_t ind, Args&&... args)
+	{
+		if (lf == nullptr)
+			root = head = tail = lf = newLeaf();
+		for (size_t j = lf->cnt; j > ind; --j)
+			moveValue(lf->at(j), lf->at(j - 1));
+		try
+		{
+			new(lf->at(ind)) value_type(std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			for (size_t j = ind; j < lf->cnt; ++j)
+				moveValue(lf->at(j), lf->at(j + 1));
+			//the construction of the first element failed
+			if (dataSize == 0)
+			{
+				dispose(root);
+				init();
+			}
+			throw;
+		}
+		++dataSize;
+		for (size_t d = 0; d < p.depth; ++d)
+			++p.x[d]->total;
+		node *z = nullptr;
+		if (++lf->cnt > leafSize)
+		{
+			leaf *y = lf, *w = newLeaf();
+			size_t m = y->cnt - y->cnt / 2;
+			for (size_t j = m; j < y->cnt; ++j)
+				moveValue(w->at(j - m), y->at(j));
+			w->cnt = y->cnt - m;
+			y->cnt = m;
+			w->prv = y;
+			w->nxt = y->nxt;
+			if (y->nxt != nullptr)
+				y->nxt->prv = w;
+			else
+				tail = w;
+			y->nxt = w;
+			if (ind >= m)
+			{
+				lf = w;
+				ind -= m;
+			}
+			z = w;
+		}
+		for (size_t d = p.depth; d > 0 && z != nullptr; --d)
+		{
+			inner *y = p.x[d - 1];
+			size_t c = p.c[d - 1];
+			for (size_t j = y->cnt; j > c; --j)
+			{
+				moveKey(y->key(j), y->key(j - 1));
+				y->ch[j + 1] = y->ch[j];
+			}
+			new(y->key(c)) Key(firstKey(z));
+			y->ch[c + 1] = z;
+			z = nullptr;
+			if (++y->cnt <= innerSize)
+				break;
+
+			//key(m) is dropped, the parent takes the first key of w as the separator
+			inner *w = newInner();
+			size_t m = y->cnt / 2;
+			for (size_t j = m + 1; j < y->cnt; ++j)
+			{
+				moveKey(w->key(j - m - 1), y->key(j));
+				w->ch[j - m - 1] = y->ch[j];
+			}
+			w->ch[y->cnt - m - 1] = y->ch[y->cnt];
+			w->cnt = y->cnt - m - 1;
+			y->key(m)->~Key();
+			y->cnt = m;
+			for (size_t j = 0; j <= w->cnt; ++j)
+				w->total += sizeOf(w->ch[j]);
+			y->total -= w->total;
+			z = w;
+		}
+		if (z != nullptr)
+		{
+			inner *r = newInner();
+			new(r->key(0)) Key(firstKey(z));
+			r->ch[0] = root;
+			r->ch[1] = z;
+			r->cnt = 1;
+			r->total = dataSize;
+			root = r;
+		}
+		return iterator(this, lf, ind);
+	}
+	//insert value_type(args...) if key does not exist, with a single descent
+	template<class... Args>
+	pair<iterator, bool> insertKey(const Key &key, Args&&... args)
+	{
+		path p;
+		leaf *lf;
+		size_t ind;
+		if (seek(key, p, lf, ind))
+			return pair<iterator, bool>(iterator(this, lf, ind), 0);
+		return pair<iterator, bool>(putAt(p, lf, ind, std::forward<Args>(args)...), 1);
+	}
+	//remove key and the child after it from x
+	static void removeKey(inner *x, size_t k)
+	{
+		x->key(k)->~Key();
+		for (size_t j = k + 1; j < x->cnt; ++j)
+		{
+			moveKey(x->key(j - 1), x->key(j));
+			x->ch[j] = x->ch[j + 1];
+		}
+		--x->cnt;
+	}
+	//refill the child c of x, which has fewer elements than minSize
+	void fix(inner *x, size_t c)
+	{
+		size_t k = c > 0 ? c - 1 : c;
+		if (x->ch[k]->isLeaf)
+		{
+			leaf *l = static_cast<leaf*>(x->ch[k]), *r = static_cast<leaf*>(x->ch[k + 1]);
+			if (l->cnt + r->cnt <= leafSize)
+			{
+				for (size_t j = 0; j < r->cnt; ++j)
+					moveValue(l->at(l->cnt + j), r->at(j));
+				l->cnt += r->cnt;
+				l->nxt = r->nxt;
+				if (r->nxt != nullptr)
+					r->nxt->prv = l;
+				else
+					tail = l;
+				dispose(r);
+				removeKey(x, k);
+				return;
+			}
+			if (l->cnt > r->cnt)
+			{
+				for (size_t j = r->cnt; j > 0; --j)
+					moveValue(r->at(j), r->at(j - 1));
+				moveValue(r->at(0), l->at(--l->cnt));
+				++r->cnt;
+			}
+			else
+			{
+				moveValue(l->at(l->cnt++), r->at(0));
+				for (size_t j = 1; j < r->cnt; ++j)
+					moveValue(r->at(j - 1), r->at(j));
+				--r->cnt;
+			}
+			x->key(k)->~Key();
+			new(x->key(k)) Key(r->at(0)->first);
+			return;
+		}
+
+		inner *l = static_cast<inner*>(x->ch[k]), *r = static_cast<inner*>(x->ch[k + 1]);
+		if (l->cnt + r->cnt + 1 <= innerSize)
+		{
+			new(l->key(l->cnt)) Key(*x->key(k));
+			for (size_t j = 0; j < r->cnt; ++j)
+			{
+				moveKey(l->key(l->cnt + 1 + j), r->key(j));
+				l->ch[l->cnt + 1 + j] = r->ch[j];
+			}
+			l->ch[l->cnt + 1 + r->cnt] = r->ch[r->cnt];
+			l->cnt += r->cnt + 1;
+			l->total += r->total;
+			dispose(r);
+			removeKey(x, k);
+			return;
+		}
+		//rotate one child through the separator
+		if (l->cnt > r->cnt)
+		{
+			r->ch[r->cnt + 1] = r->ch[r->cnt];
+			for (size_t j = r->cnt; j > 0; --j)
+			{
+				moveKey(r->key(j), r->key(j - 1));
+				r->ch[j] = r->ch[j - 1];
+			}
+			moveKey(r->key(0), x->key(k));
+			r->ch[0] = l->ch[l->cnt];
+			++r->cnt;
+			moveKey(x->key(k), l->key(--l->cnt));
+			r->total += sizeOf(r->ch[0]);
+			l->total -= sizeOf(r->ch[0]);
+		}
+		else
+		{
+			moveKey(l->key(l->cnt), x->key(k));
+			l->ch[++l->cnt] = r->ch[0];
+			l->total += sizeOf(r->ch[0]);
+			r->total -= sizeOf(r->ch[0]);
+			moveKey(x->key(k), r->key(0));
+			for (size_t j = 1; j < r->cnt; ++j)
+			{
+				moveKey(r->key(j - 1), r->key(j));
+				r->ch[j - 1] = r->ch[j];
+			}
+			r->ch[r->cnt - 1] = r->ch[r->cnt];
+			--r->cnt;
+		}
+	}
+	//erase key from the subtree x, return whether it was there
+	bool remove(node *x, const Key &key)
+	{
+		if (x->isLeaf)
+		{
+			leaf *y = static_cast<leaf*>(x);
+			size_t i = lowerOf(y, key);
+			if (i == y->cnt || cc(key, y->at(i)->first))
+				return 0;
+			y->at(i)->~value_type();
+			for (size_t j = i + 1; j < y->cnt; ++j)
+				moveValue(y->at(j - 1), y->at(j));
+			--y->cnt;
+			--dataSize;
+			return 1;
+		}
+		inner *y = static_cast<inner*>(x);
+		size_t c = childOf(y, key);
+		if (!remove(y->ch[c], key))
+			return 0;
+		--y->total;
+		if (y->ch[c]->cnt < minSize(y->ch[c]))
+			fix(y, c);
+		return 1;
+	}
+	void del(node *x)
+	{
+		if (x == nullptr)
+			return;
+		if (x->isLeaf)
+		{
+			leaf *y = static_cast<leaf*>(x);
+			for (size_t i = 0; i < y->cnt; ++i)
+				y->at(i)->~value_type();
+		}
+		else
+		{
+			inner *y = static_cast<inner*>(x);
+			for (size_t i = 0; i < y->cnt; ++i)
+				y->key(i)->~Key();
+			for (size_t i = 0; i <= y->cnt; ++i)
+				del(y->ch[i]);
+		}
+		dispose(x);
+	}
+	//copy the subtree x, the new leaves are appended to the list in order
+	node *cra(node *x)
+	{
+		if (x->isLeaf)
+		{
+			leaf *y = static_cast<leaf*>(x), *z = newLeaf();
+			for (; z->cnt < y->cnt; ++z->cnt)
+				new(z->at(z->cnt)) value_type(*y->at(z->cnt));
+			z->prv = tail;
+			if (tail != nullptr)
+				tail->nxt = z;
+			else
+				head = z;
+			tail = z;
+			return z;
+		}
+		inner *y = static_cast<inner*>(x), *z = newInner();
+		z->total = y->total;
+		for (; z->cnt < y->cnt; ++z->cnt)
+			new(z->key(z->cnt)) Key(*y->key(z->cnt));
+		for (size_t i = 0; i <= y->cnt; ++i)
+			z->ch[i] = cra(y->ch[i]);
+		return z;
+	}
+	void init()
+	{
+		root = nullptr;
+		head = tail = nullptr;
+		dataSize = 0;
+	}
+	void copy(const btree_map &other)
+	{
+		init();
+		if (other.root != nullptr)
+			root = cra(other.root);
+		dataSize = other.dataSize;
+	}
+	//move (lf, ind) to the next position, throw invalid_iterator at end
+	void succ(leaf *&lf, size_t &ind) const
+	{
+		if (lf == nullptr)
+			throw invalid_iterator();
+		if (++ind == lf->cnt)
+		{
+			lf = lf->nxt;
+			ind = 0;
+		}
+	}
+	//move (lf, ind) to the previous position, throw invalid_iterator at begin
+	void prev(leaf *&lf, size_t &ind) const
+	{
+		if (lf == nullptr)
+		{
+			if (tail == nullptr)
+				throw invalid_iterator();
+			lf = tail;
+			ind = lf->cnt;
+		}
+		else if (ind == 0)
+		{
+			if (lf->prv == nullptr)
+				throw invalid_iterator();
+			lf = lf->prv;
+			ind = lf->cnt;
+		}
+		--ind;
+	}
+public:
+	/**
+	 * see BidirectionalIterator at CppReference for help.
+	 * end() is the position with no leaf.
+	 *
+	 * if there is anything wrong throw invalid_iterator.
+	 *     like it = map.begin(); --it;
+	 *       or it = map.end(); ++end();
+	 */
+	class iterator
+	{
+		friend btree_map;
+	private:
+		btree_map *mp;
+		leaf *lf;
+		size_t ind;
+		iterator(btree_map *_mp, leaf *_lf, size_t _ind) : mp(_mp), lf(_lf), ind(_lf == nullptr ? 0 : _ind) {}
+	public:
+		iterator() : mp(nullptr), lf(nullptr), ind(0) {}
+		iterator(const iterator &other) : mp(other.mp), lf(other.lf), ind(other.ind) {}
+		iterator operator++(int)
+		{
+			iterator ret(*this);
+			mp->succ(lf, ind);
+			return ret;
+		}
+		iterator & operator++()
+		{
+			mp->succ(lf, ind);
+			return *this;
+		}
+		iterator operator--(int)
+		{
+			iterator ret(*this);
+			mp->prev(lf, ind);
+			return ret;
+		}
+		iterator & operator--()
+		{
+			mp->prev(lf, ind);
+			return *this;
+		}
+		value_type & operator*() const
+		{
+			return *lf->at(ind);
+		}
+		/**
+		 * return the distance between two iterators in O(log n),
+		 *   throw invalid_iterator if they belong to different maps.
+		 */
+		std::ptrdiff_t operator-(const iterator &rhs) const
+		{
+			if (mp != rhs.mp)
+				throw invalid_iterator();
+			return std::ptrdiff_t(mp->order(lf, ind)) - std::ptrdiff_t(mp->order(rhs.lf, rhs.ind));
+		}
+		std::ptrdiff_t operator-(const const_iterator &rhs) const
+		{
+			if (mp != rhs.mp)
+				throw invalid_iterator();
+			return std::ptrdiff_t(mp->order(lf, ind)) - std::ptrdiff_t(mp->order(rhs.lf, rhs.ind));
+		}
+		bool operator==(const iterator &rhs) const
+		{
+			return mp == rhs.mp && lf == rhs.lf && ind == rhs.ind;
+		}
+		bool operator==(const const_iterator &rhs) const
+		{
+			return mp == rhs.mp && lf == rhs.lf && ind == rhs.ind;
+		}
+		bool operator!=(const iterator &rhs) const
+		{
+			return !(*this == rhs);
+		}
+		bool operator!=(const const_iterator &rhs) const
+		{
+			return !(*this == rhs);
+		}
+		value_type* operator->() const noexcept
+		{
+			return lf->at(ind);
+		}
+	};
+	class const_iterator
+	{
+		friend btree_map;
+	private:
+		const btree_map *mp;
+		leaf *lf;
+		size_t ind;
+		const_iterator(const btree_map *_mp, leaf *_lf, size_t _ind) : mp(_mp), lf(_lf), ind(_lf == nullptr ? 0 : _ind) {}
+	public:
+		const_iterator() : mp(nullptr), lf(nullptr), ind(0) {}
+		const_iterator(const const_iterator &other) : mp(other.mp), lf(other.lf), ind(other.ind) {}
+		const_iterator(const iterator &other) : mp(other.mp), lf(other.lf), ind(other.ind) {}
+		const_iterator operator++(int)
+		{
+			const_iterator ret(*this);
+			mp->succ(lf, ind);
+			return ret;
+		}
+		const_iterator & operator++()
+		{
+			mp->succ(lf, ind);
+			return *this;
+		}
+		const_iterator operator--(int)
+		{
+			const_iterator ret(*this);
+			mp->prev(lf, ind);
+			return ret;
+		}
+		const_iterator & operator--()
+		{
+			mp->prev(lf, ind);
+			return *this;
+		}
+		const value_type & operator*() const
+		{
+			return *lf->at(ind);
+		}
+		std::ptrdiff_t operator-(const iterator &rhs) const
+		{
+			if (mp != rhs.mp)
+				throw invalid_iterator();
+			return std::ptrdiff_t(mp->order(lf, ind)) - std::ptrdiff_t(mp->order(rhs.lf, rhs.ind));
+		}
+		std::ptrdiff_t operator-(const const_iterator &rhs) const
+		{
+			if (mp != rhs.mp)
+				throw invalid_iterator();
+			return std::ptrdiff_t(mp->order(lf, ind)) - std::ptrdiff_t(mp->order(rhs.lf, rhs.ind));
+		}
+		bool operator==(const iterator &rhs) const
+		{
+			return mp == rhs.mp && lf == rhs.lf && ind == rhs.ind;
+		}
+		bool operator==(const const_iterator &rhs) const
+		{
+			return mp == rhs.mp && lf == rhs.lf && ind == rhs.ind;
+		}
+		bool operator!=(const iterator &rhs) const
+		{
+			return !(*this == rhs);
+		}
+		bool operator!=(const const_iterator &rhs) const
+		{
+			return !(*this == rhs);
+		}
+		const value_type* operator->() const noexcept
+		{
+			return lf->at(ind);
+		}
+	};
+
+	btree_map()
+	{
+		init();
+	}
+	explicit btree_map(const Compare &comp, const Allocator &_alloc = Allocator()) : cc(comp), leafAlloc(_alloc), innerAlloc(_alloc)
+	{
+		init();
+	}
+	btree_map(const btree_map &other) : cc(other.cc), leafAlloc(other.leafAlloc), innerAlloc(other.innerAlloc)
+	{
+		copy(other);
+	}
+	btree_map & operator=(const btree_map &other)
+	{
+		if (this == &other)
+			return *this;
+		del(root);
+		copy(other);
+		return *this;
+	}
+	~btree_map()
+	{
+		del(root);
+	}
+	/**
+	 * access specified element with bounds checking
+	 * If no such element exists, an exception of type `index_out_of_bound'
+	 */
+	T & at(const Key &key)
+	{
+		leaf *lf;
+		size_t ind;
+		locate(key, lf, ind);
+		if (lf == nullptr)
+			throw index_out_of_bound();
+		return lf->at(ind)->second;
+	}
+	const T & at(const Key &key) const
+	{
+		leaf *lf;
+		size_t ind;
+		locate(key, lf, ind);
+		if (lf == nullptr)
+			throw index_out_of_bound();
+		return lf->at(ind)->second;
+	}
+	/**
+	 * access specified element, performing an insertion if such key does not already exist.
+	 */
+	T & operator[](const Key &key)
+	{
+		path p;
+		leaf *lf;
+		size_t ind;
+		if (seek(key, p, lf, ind))
+			return lf->at(ind)->second;
+		return putAt(p, lf, ind, key, T())->second;
+	}
+	/**
+	 * behave like at() throw index_out_of_bound if such key does not exist.
+	 */
+	const T & operator[](const Key &key) const
+	{
+		return at(key);
+	}
+	iterator begin()
+	{
+		return iterator(this, head, 0);
+	}
+	const_iterator cbegin() const
+	{
+		return const_iterator(this, head, 0);
+	}
+	iterator end()
+	{
+		return iterator(this, nullptr, 0);
+	}
+	const_iterator cend() const
+	{
+		return const_iterator(this, nullptr, 0);
+	}
+	bool empty() const
+	{
+		return dataSize == 0;
+	}
+	size_t size() const
+	{
+		return dataSize;
+	}
+	Allocator get_allocator() const
+	{
+		return Allocator(leafAlloc);
+	}
+	void clear()
+	{
+		del(root);
+		init();
+	}
+	/**
+	 * insert an element, return the same as sjtu::map::insert.
+	 */
+	pair<iterator, bool> insert(const value_type &value)
+	{
+		return insertKey(value.first, value);
+	}
+	pair<iterator, bool> insert(value_type &&value)
+	{
+		return insertKey(value.first, std::move(value));
+	}
+	/**
+	 * if key does not exist, insert (key, T(args...)), otherwise do nothing.
+	 */
+	template<class... Args>
+	pair<iterator, bool> try_emplace(const Key &key, Args&&... args)
+	{
+		path p;
+		leaf *lf;
+		size_t ind;
+		if (seek(key, p, lf, ind))
+			return pair<iterator, bool>(iterator(this, lf, ind), 0);
+		return pair<iterator, bool>(putAt(p, lf, ind, key, T(std::forward<Args>(args)...)), 1);
+	}
+	/**
+	 * construct value_type(args...) and insert it if its key does not exist.
+	 * the value is built first to know its key, and released if the key exists.
+	 * return the same as insert.
+	 */
+	template<class... Args>
+	pair<iterator, bool> emplace(Args&&... args)
+	{
+		typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type buf;
+		value_type *tmp = new(&buf) value_type(std::forward<Args>(args)...);
+		try
+		{
+			pair<iterator, bool> ret = insertKey(tmp->first, std::move(*tmp));
+			tmp->~value_type();
+			return ret;
+		}
+		catch (...)
+		{
+			tmp->~value_type();
+			throw;
+		}
+	}
+	/**
+	 * erase the element at pos.
+	 *
+	 * throw if pos pointed to a bad element (pos == this->end() || pos points an element out of this)
+	 */
+	void erase(iterator pos)
+	{
+		if (pos.mp != this || pos.lf == nullptr)
+			throw invalid_iterator();
+		remove(root, pos->first);
+		if (root->cnt == 0)
+		{
+			node *x = root;
+			if (x->isLeaf)
+				root = head = tail = nullptr;
+			else
+				root = static_cast<inner*>(x)->ch[0];
+			dispose(x);
+		}
+	}
+	size_t count(const Key &key) const
+	{
+		leaf *lf;
+		size_t ind;
+		locate(key, lf, ind);
+		return lf != nullptr;
+	}
+	iterator find(const Key &key)
+	{
+		leaf *lf;
+		size_t ind;
+		locate(key, lf, ind);
+		return iterator(this, lf, ind);
+	}
+	const_iterator find(const Key &key) const
+	{
+		leaf *lf;
+		size_t ind;
+		locate(key, lf, ind);
+		return const_iterator(this, lf, ind);
+	}
+	iterator lower_bound(const Key &key)
+	{
+		leaf *lf;
+		size_t ind;
+		bound(key, 0, lf, ind);
+		return iterator(this, lf, ind);
+	}
+	const_iterator lower_bound(const Key &key) const
+	{
+		leaf *lf;
+		size_t ind;
+		bound(key, 0, lf, ind);
+		return const_iterator(this, lf, ind);
+	}
+	iterator upper_bound(const Key &key)
+	{
+		leaf *lf;
+		size_t ind;
+		bound(key, 1, lf, ind);
+		return iterator(this, lf, ind);
+	}
+	const_iterator upper_bound(const Key &key) const
+	{
+		leaf *lf;
+		size_t ind;
+		bound(key, 1, lf, ind);
+		return const_iterator(this, lf, ind);
+	}
+	pair<iterator, iterator> equal_range(const Key &key)
+	{
+		return pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+	}
+	pair<const_iterator, const_iterator> equal_range(const Key &key) const
+	{
+		return pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+	}
+	/**
+	 * return an iterator to the k-th smallest element (counting from 0) in O(log n),
+	 *   throw index_out_of_bound if k >= size().
+	 */
+	iterator nth(size_t k)
+	{
+		leaf *lf;
+		size_t ind;
+		select(k, lf, ind);
+		return iterator(this, lf, ind);
+	}
+	const_iterator nth(size_t k) const
+	{
+		leaf *lf;
+		size_t ind;
+		select(k, lf, ind);
+		return const_iterator(this, lf, ind);
+	}
+	/**
+	 * return the number of elements whose key is less than key, in O(log n).
+	 */
+	size_t rank(const Key &key) const
+	{
+		return rankOf(key);
+	}
+	/**
+	 * call f(value) on every element whose key is in [lo, hi), in key order,
+	 *   walking the leaves from the lower bound of lo.
+	 * f must not insert into or erase from this map.
+	 */
+	template<class F>
+	void for_each_in(const Key &lo, const Key &hi, F f)
+	{
+		leaf *lf;
+		size_t ind;
+		bound(lo, 0, lf, ind);
+		for (; lf != nullptr; lf = lf->nxt, ind = 0)
+			for (; ind < lf->cnt; ++ind)
+			{
+				if (!cc(lf->at(ind)->first, hi))
+					return;
+				f(*lf->at(ind));
+			}
+	}
+	template<class F>
+	void for_each_in(const Key &lo, const Key &hi, F f) const
+	{
+		leaf *lf;
+		size_t ind;
+		bound(lo, 0, lf, ind);
+		for (; lf != nullptr; lf = lf->nxt, ind = 0)
+			for (; ind < lf->cnt; ++ind)
+			{
+				if (!cc(lf->at(ind)->first, hi))
+					return;
+				f(static_cast<const value_type &>(*lf->at(ind)));
+			}
+	}
+};
+
+}
+
+#endif
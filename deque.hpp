@@ -4,141 +4,533 @@
 #include "exceptions.hpp"
 
 #include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
-namespace sjtu { 
+namespace sjtu {
 
-template<class T>
+#ifndef SJTU_IS_TRIVIALLY_RELOCATABLE
+#define SJTU_IS_TRIVIALLY_RELOCATABLE
+/**
+ * whether an object of T can be moved to another address by a plain memmove
+ *   (and the old one forgotten without calling the destructor).
+ * true for trivially copyable types, specialize it for classes which never
+ *   hold pointers into themselves to get the bulk path.
+ * vector and deque both declare it, the guard keeps it to one definition.
+ */
+template<typename T>
+struct is_trivially_relocatable : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+#endif
+
+/**
+ * blocks and their element buffers are obtained from Allocator (rebound to their types).
+ * like std::deque, push and pop at either end keep the iterators to the other elements
+ *   valid, while insert and erase in the middle invalidate them.
+ * a block holds up to 2 * BlockSize elements, by default about a page of them.
+ * BlockSize = 0 lets the block size follow the size of the deque (about sqrt(n)), so that
+ *   moving elements inside a block and relabelling the blocks cost about the same.
+ */
+template<class T, class Allocator = std::allocator<T>,
+	size_t BlockSize = (sizeof(T) <= 128 ? 2048 / sizeof(T) : 16)>
 class deque
 {
 private:
-	const size_t B = 256;
-	class node;
+	/**
+	 * a block keeps up to cap elements in one buffer, at data[head, head + size).
+	 * blocks never move, so an iterator is a block and a slot of its buffer.
+	 * id is the index of the block in table, and start labels the position of its
+	 *   first element: the element at data[head + i] is at start - origin + i
+	 *   (in unsigned arithmetic, so the labels may wrap around).
+	 */
 	class block{
 	public:
-		size_t size;
-		block *prev, *succ;
-		node *listHead, *listTail;
-		block()
+		size_t size, head, id, start, cap;
+		T *data;
+		block(T *_data, size_t _cap, size_t _head)
 		{
 			size = 0;
-			prev = succ = nullptr;
-			listHead = listTail = nullptr;
+			head = _head;
+			cap = _cap;
+			id = start = 0;
+			data = _data;
 		}
-		block(const size_t &other)
+	};
+	typedef std::allocator_traits<Allocator> alloc_traits;
+	typedef typename alloc_traits::template rebind_alloc<block*> table_allocator;
+	Allocator alloc;
+	typename alloc_traits::template rebind_alloc<block> blockAlloc;
+	table_allocator tableAlloc;
+	size_t dataSize;
+	block *blockHead, *blockTail;
+	/**
+	 * the blocks in order are table[tableHead, tableHead + tableSize),
+	 *   with room kept at both ends like the buffer of a block.
+	 */
+	block **table;
+	size_t tableHead, tableSize, tableCap;
+	size_t origin;
+
+	/**
+	 * allocate an U from a and construct it from args.
+	 */
+	template<class U, class A, class... Args>
+	static U *create(A &a, Args&&... args)
+	{
+		U *ret = std::allocator_traits<A>::allocate(a, 1);
+		new(ret) U(std::forward<Args>(args)...);
+		return ret;
+	}
+	template<class U, class A>
+	static void dispose(A &a, U *x)
+	{
+		x->~U();
+		std::allocator_traits<A>::deallocate(a, x, 1);
+	}
+	/**
+	 * move n elements from src to dst, the old ones are destroyed.
+	 * the two ranges may overlap.
+	 */
+	static void relocate(T *dst, T *src, size_t n, std::true_type)
+	{
+		if (n != 0)
+			memmove((void*) dst, (void*) src, sizeof(T) * n);
+	}
+	static void relocate(T *dst, T *src, size_t n, std::false_type)
+	{
+		if (dst == src)
+			return;
+		if (dst < src)
 		{
-			size = other;
-			prev = succ = nullptr;
-			listHead = listTail = nullptr;
+			for (size_t i = 0; i < n; ++i)
+			{
+				new(&dst[i]) T(std::move(src[i]));
+				src[i].~T();
+			}
 		}
-		~block()
+		else
 		{
-			for (node *i = listHead, *j; i != nullptr; i = j)
+			for (size_t i = n; i > 0; --i)
 			{
-				j = i->succ;
-				delete i;
+				new(&dst[i - 1]) T(std::move(src[i - 1]));
+				src[i - 1].~T();
 			}
 		}
-	};
-	class node{
-	public:
-		T *data;
-		block *par;
-		node *prev, *succ;
-		node()
+	}
+	static void relocate(T *dst, T *src, size_t n)
+	{
+		relocate(dst, src, n, is_trivially_relocatable<T>());
+	}
+	//the capacity of a new block
+	size_t capacity() const
+	{
+		if (BlockSize != 0)
+			return 2 * BlockSize;
+		size_t b = 16;
+		while (b * b < dataSize)
+			b *= 2;
+		return 2 * b;
+	}
+	//an empty block of cap elements whose elements will start from head
+	block *newBlock(size_t cap, size_t head)
+	{
+		T *data = alloc_traits::allocate(alloc, cap);
+		try
 		{
-			data = nullptr;
-			par = nullptr;
-			prev = succ = nullptr;
+			return create<block>(blockAlloc, data, cap, head);
 		}
-		node(const T &other)
+		catch (...)
 		{
-			data = new T(other);
-			par = nullptr;
-			prev = succ = nullptr;
+			alloc_traits::deallocate(alloc, data, cap);
+			throw;
 		}
-		~node()
+	}
+	//free a block with its elements
+	void dispose(block *blk)
+	{
+		for (size_t i = 0; i < blk->size; ++i)
+			blk->data[blk->head + i].~T();
+		alloc_traits::deallocate(alloc, blk->data, blk->cap);
+		dispose(blockAlloc, blk);
+	}
+	//the neighbours of blk, nullptr if none
+	block *prevOf(block *blk) const
+	{
+		return blk->id == tableHead ? nullptr : table[blk->id - 1];
+	}
+	block *succOf(block *blk) const
+	{
+		return blk->id + 1 == tableHead + tableSize ? nullptr : table[blk->id + 1];
+	}
+	//the index of blk among the blocks
+	size_t order(block *blk) const
+	{
+		return blk->id - tableHead;
+	}
+	/**
+	 * make sure one more block can be linked without reallocating the table,
+	 *   so that link() does not throw.
+	 */
+	void reserve()
+	{
+		if (tableSize < tableCap)
+			return;
+		size_t cap = tableCap * 2, h = (cap - tableSize) / 2;
+		block **tmp = std::allocator_traits<table_allocator>::allocate(tableAlloc, cap);
+		for (size_t i = 0; i < tableSize; ++i)
 		{
-			if (data != nullptr)
-				delete data;
+			tmp[h + i] = table[tableHead + i];
+			tmp[h + i]->id = h + i;
 		}
-	};
-	size_t dataSize;
-	block *blockHead, *blockTail;
-	
+		std::allocator_traits<table_allocator>::deallocate(tableAlloc, table, tableCap);
+		table = tmp;
+		tableHead = h;
+		tableCap = cap;
+	}
+	//put x into the table at index k (0 <= k <= tableSize), the shorter side is moved
+	void link(block *x, size_t k)
+	{
+		if (tableHead + tableSize == tableCap || (tableHead != 0 && k < tableSize - k))
+		{
+			--tableHead;
+			for (size_t i = 0; i < k; ++i)
+			{
+				table[tableHead + i] = table[tableHead + i + 1];
+				table[tableHead + i]->id = tableHead + i;
+			}
+		}
+		else
+		{
+			for (size_t i = tableSize; i > k; --i)
+			{
+				table[tableHead + i] = table[tableHead + i - 1];
+				table[tableHead + i]->id = tableHead + i;
+			}
+		}
+		table[tableHead + k] = x;
+		x->id = tableHead + k;
+		++tableSize;
+		blockHead = table[tableHead];
+		blockTail = table[tableHead + tableSize - 1];
+	}
+	void unlink(block *x)
+	{
+		size_t k = order(x);
+		if (k < tableSize - 1 - k)
+		{
+			for (size_t i = k; i > 0; --i)
+			{
+				table[tableHead + i] = table[tableHead + i - 1];
+				table[tableHead + i]->id = tableHead + i;
+			}
+			++tableHead;
+		}
+		else
+		{
+			for (size_t i = k; i + 1 < tableSize; ++i)
+			{
+				table[tableHead + i] = table[tableHead + i + 1];
+				table[tableHead + i]->id = tableHead + i;
+			}
+		}
+		--tableSize;
+		blockHead = table[tableHead];
+		blockTail = table[tableHead + tableSize - 1];
+	}
+	/**
+	 * an element was added to (d = 1) or removed from (d = -1) blk.
+	 * the positions after it change by d, which is done by moving the labels of
+	 *   the blocks after blk, or those up to blk together with origin, whichever are fewer.
+	 */
+	void relabel(block *blk, size_t d)
+	{
+		size_t k = order(blk);
+		if (k < tableSize - 1 - k)
+		{
+			origin -= d;
+			for (size_t i = 0; i <= k; ++i)
+				table[tableHead + i]->start -= d;
+		}
+		else
+		{
+			for (size_t i = k + 1; i < tableSize; ++i)
+				table[tableHead + i]->start += d;
+		}
+	}
+	//an empty table with room for a few blocks
+	void initTable()
+	{
+		tableCap = 8;
+		table = std::allocator_traits<table_allocator>::allocate(tableAlloc, tableCap);
+		tableHead = tableCap / 2;
+		tableSize = 0;
+		origin = 0;
+	}
+	//one empty block, its elements start from the middle so that both ends can grow
+	void init()
+	{
+		initTable();
+		dataSize = 0;
+		block *blk;
+		try
+		{
+			blk = newBlock(capacity(), capacity() / 2);
+		}
+		catch (...)
+		{
+			std::allocator_traits<table_allocator>::deallocate(tableAlloc, table, tableCap);
+			throw;
+		}
+		link(blk, 0);
+	}
+	void copy(const deque &other)
+	{
+		initTable();
+		try
+		{
+			for (size_t k = 0; k < other.tableSize; ++k)
+			{
+				block *i = other.table[other.tableHead + k];
+				reserve();
+				link(newBlock(i->cap, i->head), k);
+				blockTail->start = i->start - other.origin;
+				for (; blockTail->size < i->size; ++blockTail->size)
+					new(&blockTail->data[i->head + blockTail->size]) T(i->data[i->head + blockTail->size]);
+			}
+		}
+		catch (...)
+		{
+			release();
+			throw;
+		}
+		dataSize = other.dataSize;
+	}
+	void release()
+	{
+		for (size_t i = 0; i < tableSize; ++i)
+			dispose(table[tableHead + i]);
+		std::allocator_traits<table_allocator>::deallocate(tableAlloc, table, tableCap);
+	}
+
+	//move the back half of the elements of blk into a new block after it
 	void split(block *blk)
 	{
-		node *pos = blk->listHead;
-		block *tmpBlock = new block(blk->size / 2);
-		for (int i = 1; i < blk->size / 2; i++)
-		{
-			pos->par = tmpBlock;
-			pos = pos->succ;
-		}
-		pos->par = tmpBlock;
-		
-		tmpBlock->listHead = blk->listHead;
-		tmpBlock->listTail = pos;
-		tmpBlock->prev = blk->prev;
-		tmpBlock->succ = blk;
-		
-		blk->listHead = pos->succ;
-		blk->size -= tmpBlock->size;
-		if (blk->prev == nullptr)
-			blockHead = tmpBlock;
+		reserve();
+		size_t n = blk->size - blk->size / 2;
+		block *tmpBlock = newBlock(blk->cap, (blk->cap - n) / 2);
+		relocate(tmpBlock->data + tmpBlock->head, blk->data + blk->head + blk->size - n, n);
+		tmpBlock->size = n;
+		blk->size -= n;
+		tmpBlock->start = blk->start + blk->size;
+		link(tmpBlock, order(blk) + 1);
+	}
+	//move the elements of blk into a buffer of the capacity of a new block, in the middle of it
+	void grow(block *blk)
+	{
+		size_t cap = capacity(), h = (cap - blk->size) / 2;
+		T *data = alloc_traits::allocate(alloc, cap);
+		relocate(data + h, blk->data + blk->head, blk->size);
+		alloc_traits::deallocate(alloc, blk->data, blk->cap);
+		blk->data = data;
+		blk->cap = cap;
+		blk->head = h;
+	}
+	/**
+	 * move the elements of blk into a neighbour with enough room and free blk.
+	 * ind is an index in blk, it is changed to the same element in the neighbour.
+	 */
+	void merge(block *&blk, size_t &ind)
+	{
+		block *tmpBlock = prevOf(blk);
+		if (tmpBlock != nullptr && tmpBlock->size + blk->size <= tmpBlock->cap)
+		{
+			if (tmpBlock->head + tmpBlock->size + blk->size > tmpBlock->cap)
+			{
+				size_t h = (tmpBlock->cap - tmpBlock->size - blk->size) / 2;
+				relocate(tmpBlock->data + h, tmpBlock->data + tmpBlock->head, tmpBlock->size);
+				tmpBlock->head = h;
+			}
+			relocate(tmpBlock->data + tmpBlock->head + tmpBlock->size, blk->data + blk->head, blk->size);
+			ind += tmpBlock->size;
+		}
 		else
-			blk->prev->succ = tmpBlock;
-		blk->prev = tmpBlock;
-		
-		pos->succ->prev = nullptr;
-		pos->succ = nullptr;
+		{
+			tmpBlock = succOf(blk);
+			if (tmpBlock == nullptr || tmpBlock->size + blk->size > tmpBlock->cap)
+				return;
+			if (tmpBlock->head < blk->size)
+			{
+				size_t h = (tmpBlock->cap - tmpBlock->size - blk->size) / 2 + blk->size;
+				relocate(tmpBlock->data + h, tmpBlock->data + tmpBlock->head, tmpBlock->size);
+				tmpBlock->head = h;
+			}
+			tmpBlock->head -= blk->size;
+			tmpBlock->start = blk->start;
+			relocate(tmpBlock->data + tmpBlock->head, blk->data + blk->head, blk->size);
+		}
+		tmpBlock->size += blk->size;
+		blk->size = 0;
+		unlink(blk);
+		dispose(blk);
+		blk = tmpBlock;
 	}
-	void merge(block *blk)
+	/**
+	 * free blk if it became empty, or merge it into a neighbour if it became small
+	 *   (only if small is set, since merging moves elements to another block).
+	 * (blk, ind) is an index in blk, it is kept pointing to the same element.
+	 */
+	void maintain(block *&blk, size_t &ind, bool small)
 	{
-		if (blk->prev != nullptr)
+		if (blk->size == 0 && blockHead != blockTail)
 		{
-			block *tmpBlock = blk->prev;
-			tmpBlock->succ = blk->succ;
-			if (blk->succ != nullptr)
-				blk->succ->prev = tmpBlock;
-			else
-				blockTail = tmpBlock;
-			tmpBlock->size += blk->size;
-			tmpBlock->listTail->succ = blk->listHead;
-			blk->listHead->prev = tmpBlock->listTail;
-			tmpBlock->listTail = blk->listTail;
-			for (node *i = blk->listHead; i != nullptr; i = i->succ)
-				i->par = tmpBlock;
-			
-			blk->listHead = nullptr;
-			blk->listTail = nullptr;
-			delete blk;
-		}
-		else if (blk->succ != nullptr)
-		{
-			block *tmpBlock = blk->succ;
-			tmpBlock->prev = blk->prev;
-			if (blk->prev != nullptr)
-				blk->prev->succ = tmpBlock;
+			block *tmpBlock = succOf(blk);
+			unlink(blk);
+			dispose(blk);
+			if (tmpBlock != nullptr)
+			{
+				blk = tmpBlock;
+				ind = 0;
+			}
 			else
-				blockHead = tmpBlock;
-			tmpBlock->size += blk->size;
-			tmpBlock->listHead->prev = blk->listTail;
-			blk->listTail->succ = tmpBlock->listHead;
-			tmpBlock->listHead = blk->listHead;
-			for (node *i = blk->listTail; i != nullptr; i = i->prev)
-				i->par = tmpBlock;
-				
-			blk->listHead = nullptr;
-			blk->listTail = nullptr;
-			delete blk;
-		}
-	}
-	void maintain(block *blk)
-	{
-		if (blk->size >= 2 * B)
+			{
+				blk = blockTail;
+				ind = blk->size;
+			}
+		}
+		else if (small && blk->size <= blk->cap / 4)
+			merge(blk, ind);
+		if (ind == blk->size && blk != blockTail)
+		{
+			blk = succOf(blk);
+			ind = 0;
+		}
+	}
+	/**
+	 * destroy the element at index ind of blk, the elements on its shorter side in blk
+	 *   are moved over the hole. (blk, ind) is changed to the element after it.
+	 * at either end of the deque no other element is moved, and blk is only freed
+	 *   once it is empty, so pop_back and pop_front pass small = false.
+	 */
+	void remove(block *&blk, size_t &ind, bool small)
+	{
+		size_t slot = blk->head + ind;
+		blk->data[slot].~T();
+		if (ind < blk->size - 1 - ind)
+		{
+			relocate(blk->data + blk->head + 1, blk->data + blk->head, ind);
+			++blk->head;
+		}
+		else
+			relocate(blk->data + slot, blk->data + slot + 1, blk->size - 1 - ind);
+		--blk->size;
+		--dataSize;
+		relabel(blk, -1);
+		maintain(blk, ind, small);
+	}
+	/**
+	 * make room for a new element at index ind of blk (ind <= blk->size) and return its slot,
+	 *   the slot is counted in blk->size but left uninitialized.
+	 * a full block is split first (or moved to a larger buffer if it is smaller than a new
+	 *   block would be), then the elements before ind are moved forward or those after it
+	 *   backward, whichever side has room and fewer elements.
+	 */
+	size_t gap(block *&blk, size_t ind)
+	{
+		if (blk->size == blk->cap && blk->cap < capacity())
+			grow(blk);
+		else if (blk->size == blk->cap)
+		{
 			split(blk);
-		if (blk->size <= B / 2)
-			merge(blk);
+			if (ind > blk->size)
+			{
+				ind -= blk->size;
+				blk = succOf(blk);
+			}
+		}
+		if (blk->head + blk->size == blk->cap || (blk->head != 0 && ind < blk->size - ind))
+		{
+			relocate(blk->data + blk->head - 1, blk->data + blk->head, ind);
+			--blk->head;
+		}
+		else
+			relocate(blk->data + blk->head + ind + 1, blk->data + blk->head + ind, blk->size - ind);
+		++blk->size;
+		return blk->head + ind;
+	}
+	//the index of (blk, slot) in the deque, in O(1)
+	size_t position(block *blk, size_t slot) const
+	{
+		return blk->start - origin + (slot - blk->head);
+	}
+	//the block and slot of the element at pos (end() if pos == dataSize), by a binary search of the table
+	void locate(size_t pos, block *&blk, size_t &slot) const
+	{
+		if (pos == dataSize)
+		{
+			blk = blockTail;
+			slot = blk->head + blk->size;
+			return;
+		}
+		size_t l = tableHead, r = tableHead + tableSize - 1;
+		while (l < r)
+		{
+			size_t mid = (l + r + 1) / 2;
+			if (table[mid]->start - origin <= pos)
+				l = mid;
+			else
+				r = mid - 1;
+		}
+		blk = table[l];
+		slot = blk->head + (pos - (blk->start - origin));
+	}
+	/**
+	 * move (blk, slot) n elements forward (backward if n < 0), within the block if
+	 *   possible, otherwise by locating the new position.
+	 * throw invalid_iterator if it would go out of [begin(), end()].
+	 */
+	void step(block *&blk, size_t &slot, std::ptrdiff_t n) const
+	{
+		std::ptrdiff_t ind = slot - blk->head;
+		if (ind + n >= 0 && ind + n < (std::ptrdiff_t) blk->size)
+		{
+			slot += n;
+			return;
+		}
+		std::ptrdiff_t pos = (std::ptrdiff_t) position(blk, slot) + n;
+		if (pos < 0 || pos > (std::ptrdiff_t) dataSize)
+			throw invalid_iterator();
+		locate(pos, blk, slot);
+	}
+	//the next slot of (blk, slot), throw invalid_iterator if it is end()
+	void next(block *&blk, size_t &slot) const
+	{
+		if (slot + 1 < blk->head + blk->size)
+			++slot;
+		else if (blk != blockTail)
+		{
+			blk = succOf(blk);
+			slot = blk->head;
+		}
+		else if (slot < blk->head + blk->size)
+			++slot;
+		else
+			throw invalid_iterator();
+	}
+	//the previous slot of (blk, slot), throw invalid_iterator if it is begin()
+	void prev(block *&blk, size_t &slot) const
+	{
+		if (slot > blk->head)
+			--slot;
+		else if (blk != blockHead)
+		{
+			blk = prevOf(blk);
+			slot = blk->head + blk->size - 1;
+		}
+		else
+			throw invalid_iterator();
 	}
 public:
 	class const_iterator;
@@ -150,145 +542,68 @@ public:
 		 *   just add whatever you want.
 		 */
 		deque *dq;
-		node *nd;
+		block *blk;
+		size_t slot;
 	public:
-		iterator(deque *_dq, node *_nd) : dq(_dq), nd(_nd) {}
-		iterator() : dq(nullptr), nd(nullptr) {}
-		iterator(const iterator &other) : dq(other.dq), nd(other.nd) {}
+		/**
+		 * the position of an element is known in O(1) (see block), so the distance and
+		 *   the order of two iterators are O(1), and +n / -n are O(log) at worst.
+		 */
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef T* pointer;
+		typedef T& reference;
+
+		iterator(deque *_dq, block *_blk, size_t _slot) : dq(_dq), blk(_blk), slot(_slot) {}
+		iterator() : dq(nullptr), blk(nullptr), slot(0) {}
+		iterator(const iterator &other) : dq(other.dq), blk(other.blk), slot(other.slot) {}
 		iterator & operator=(const iterator &other)
 		{
 			dq = other.dq;
-			nd = other.nd;
+			blk = other.blk;
+			slot = other.slot;
+			return *this;
 		}
 		/**
 		 * return a new iterator which pointer n-next elements
 		 *   even if there are not enough elements, the behaviour is **undefined**.
 		 * as well as operator-
 		 */
-		iterator operator+(const int &n) const
+		iterator operator+(const difference_type &n) const
 		{
-			if (n < 0)
-				return (*this - (-n));
-			int res = n;
-			node *tmpNode = nd;
-			while (res > 0 && tmpNode->succ != nullptr)
-			{
-				--res;
-				tmpNode = tmpNode->succ;
-			}
-			if (res == 0)
-				return iterator(dq, tmpNode);
-			
-			--res;
-			block *tmpBlock = tmpNode->par->succ;
-			if (tmpBlock == nullptr)
-				throw invalid_iterator();
-			res -= tmpBlock->size;
-			while (res >= 0 && tmpBlock->succ != nullptr)
-			{
-				tmpBlock = tmpBlock->succ;
-				res -= tmpBlock->size;
-			}
-			res += tmpBlock->size;
-			
-			tmpNode = tmpBlock->listHead;
-			while (res > 0 && tmpNode->succ != nullptr)
-			{
-				--res;
-				tmpNode = tmpNode->succ;
-			}
-			if (res > 0)
-				throw invalid_iterator();
-			return iterator(dq, tmpNode);
+			iterator ret(*this);
+			dq->step(ret.blk, ret.slot, n);
+			return ret;
 		}
-		iterator operator-(const int &n) const
+		iterator operator-(const difference_type &n) const
 		{
-			if (n < 0)
-				return (*this + (-n));
-			int res = n;
-			node *tmpNode = nd;
-			while (res > 0 && tmpNode->prev != nullptr)
-			{
-				--res;
-				tmpNode = tmpNode->prev;
-			}
-			if (res == 0)
-				return iterator(dq, tmpNode);
-			
-			--res;
-			block *tmpBlock = tmpNode->par->prev;
-			if (tmpBlock == nullptr)
-				throw invalid_iterator();
-			res -= tmpBlock->size;
-			while (res >= 0 && tmpBlock->prev != nullptr)
-			{
-				tmpBlock = tmpBlock->prev;
-				res -= tmpBlock->size;
-			}
-			res += tmpBlock->size;
-			
-			tmpNode = tmpBlock->listTail;
-			while (res > 0 && tmpNode->prev != nullptr)
-			{
-				--res;
-				tmpNode = tmpNode->prev;
-			}
-			if (res > 0)
-				throw invalid_iterator();
-			return iterator(dq, tmpNode);
+			iterator ret(*this);
+			dq->step(ret.blk, ret.slot, -n);
+			return ret;
 		}
 		// return th distance between two iterator,
 		// if these two iterators points to different vectors, throw invaild_iterator.
-		int operator-(const iterator &rhs) const
+		difference_type operator-(const iterator &rhs) const
 		{
 			if (dq != rhs.dq)
 				throw invalid_iterator();
-			int ret = 0, cur = 0;
-			for (block *i = dq->blockHead; i != nullptr; cur += i->size, i = i->succ)
-			{
-				if (nd->par == i || rhs.nd->par == i)
-				{
-					for (node *j = i->listHead; j != nullptr; ++cur, j = j->succ)
-					{
-						if (nd == j)
-							ret += cur;
-						if (rhs.nd == j)
-							ret -= cur;
-					}
-					cur -= i->size;
-				}
-			}
-			return ret;
+			return (difference_type) dq->position(blk, slot) - (difference_type) dq->position(rhs.blk, rhs.slot);
 		}
-		int operator-(const const_iterator &rhs) const
+		difference_type operator-(const const_iterator &rhs) const
 		{
 			if (dq != rhs.dq)
 				throw invalid_iterator();
-			int ret = 0, cur = 0;
-			for (block *i = dq->blockHead; i != nullptr; cur += i->size, i = i->succ)
-			{
-				if (nd->par == i || rhs.nd->par == i)
-				{
-					for (node *j = i->listHead; j != nullptr; ++cur, j = j->succ)
-					{
-						if (nd == j)
-							ret += cur;
-						if (rhs.nd == j)
-							ret -= cur;
-					}
-					cur -= i->size;
-				}
-			}
-			return ret;
+			return (difference_type) dq->position(blk, slot) - (difference_type) dq->position(rhs.blk, rhs.slot);
 		}
-		iterator operator+=(const int &n)
+		iterator& operator+=(const difference_type &n)
 		{
-			*this = (*this + n);
+			dq->step(blk, slot, n);
 			return *this;
 		}
-		iterator operator-=(const int &n)
+		iterator& operator-=(const difference_type &n)
 		{
-			*this = (*this - n);
+			dq->step(blk, slot, -n);
 			return *this;
 		}
 		/**
@@ -296,8 +611,8 @@ public:
 		 */
 		iterator operator++(int)
 		{
-			iterator ret(dq, nd);
-			*this += 1;
+			iterator ret(*this);
+			dq->next(blk, slot);
 			return ret;
 		}
 		/**
@@ -305,7 +620,7 @@ public:
 		 */
 		iterator& operator++()
 		{
-			*this += 1;
+			dq->next(blk, slot);
 			return *this;
 		}
 		/**
@@ -313,8 +628,8 @@ public:
 		 */
 		iterator operator--(int)
 		{
-			iterator ret(dq, nd);
-			*this -= 1;
+			iterator ret(*this);
+			dq->prev(blk, slot);
 			return ret;
 		}
 		/**
@@ -322,7 +637,7 @@ public:
 		 */
 		iterator& operator--()
 		{
-			*this -= 1;
+			dq->prev(blk, slot);
 			return *this;
 		}
 		/**
@@ -332,7 +647,7 @@ public:
 		{
 			if (*this == dq->end())
 				throw invalid_iterator();
-			return *(nd->data);
+			return blk->data[slot];
 		}
 		/**
 		 * TODO it->field
@@ -341,29 +656,53 @@ public:
 		{
 			if (*this == dq->end())
 				throw invalid_iterator();
-			return nd->data;
+			return &blk->data[slot];
+		}
+		T& operator[](const difference_type &n) const
+		{
+			return *(*this + n);
 		}
 		/**
 		 * a operator to check whether two iterators are same (pointing to the same memory).
 		 */
 		bool operator==(const iterator &rhs) const
 		{
-			return (dq == rhs.dq) && (nd == rhs.nd);
+			return (dq == rhs.dq) && (blk == rhs.blk) && (slot == rhs.slot);
 		}
 		bool operator==(const const_iterator &rhs) const
 		{
-			return (dq == rhs.dq) && (nd == rhs.nd);
+			return (dq == rhs.dq) && (blk == rhs.blk) && (slot == rhs.slot);
 		}
 		/**
 		 * some other operator for iterator.
 		 */
 		bool operator!=(const iterator &rhs) const
 		{
-			return (dq != rhs.dq) || (nd != rhs.nd);
+			return !(*this == rhs);
 		}
 		bool operator!=(const const_iterator &rhs) const
 		{
-			return (dq != rhs.dq) || (nd != rhs.nd);
+			return !(*this == rhs);
+		}
+		bool operator<(const iterator &rhs) const
+		{
+			return *this - rhs < 0;
+		}
+		bool operator>(const iterator &rhs) const
+		{
+			return *this - rhs > 0;
+		}
+		bool operator<=(const iterator &rhs) const
+		{
+			return *this - rhs <= 0;
+		}
+		bool operator>=(const iterator &rhs) const
+		{
+			return *this - rhs >= 0;
+		}
+		friend iterator operator+(const difference_type &n, const iterator &rhs)
+		{
+			return rhs + n;
 		}
 	};
 	class const_iterator {
@@ -372,147 +711,66 @@ public:
 		friend deque;
 	private:
 		const deque *dq;
-		node *nd;
-		
+		block *blk;
+		size_t slot;
+
 	public:
-		const_iterator(const deque *_dq, node *_nd) : dq(_dq), nd(_nd) {}
-		const_iterator() : dq(nullptr), nd(nullptr) {}
-		const_iterator(const const_iterator &other) : dq(other.dq), nd(other.nd) {}
-		const_iterator(const iterator &other) : dq(other.dq), nd(other.nd) {}
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const T* pointer;
+		typedef const T& reference;
+
+		const_iterator(const deque *_dq, block *_blk, size_t _slot) : dq(_dq), blk(_blk), slot(_slot) {}
+		const_iterator() : dq(nullptr), blk(nullptr), slot(0) {}
+		const_iterator(const const_iterator &other) : dq(other.dq), blk(other.blk), slot(other.slot) {}
+		const_iterator(const iterator &other) : dq(other.dq), blk(other.blk), slot(other.slot) {}
 		const_iterator & operator=(const iterator &other)
 		{
 			dq = other.dq;
-			nd = other.nd;
+			blk = other.blk;
+			slot = other.slot;
+			return *this;
 		}
 			/**
 		 * return a new iterator which pointer n-next elements
 		 *   even if there are not enough elements, the behaviour is **undefined**.
 		 * as well as operator-
 		 */
-		const_iterator operator+(const int &n) const
+		const_iterator operator+(const difference_type &n) const
 		{
-			if (n < 0)
-				return (*this - (-n));
-			int res = n;
-			node *tmpNode = nd;
-			while (res > 0 && tmpNode->succ != nullptr)
-			{
-				--res;
-				tmpNode = tmpNode->succ;
-			}
-			if (res == 0)
-				return const_iterator(dq, tmpNode);
-			
-			--res;
-			block *tmpBlock = tmpNode->par->succ;
-			if (tmpBlock == nullptr)
-				throw invalid_iterator();
-			res -= tmpBlock->size;
-			while (res >= 0 && tmpBlock->succ != nullptr)
-			{
-				tmpBlock = tmpBlock->succ;
-				res -= tmpBlock->size;
-			}
-			res += tmpBlock->size;
-			
-			tmpNode = tmpBlock->listHead;
-			while (res > 0 && tmpNode->succ != nullptr)
-			{
-				--res;
-				tmpNode = tmpNode->succ;
-			}
-			if (res > 0)
-				throw invalid_iterator();
-			return const_iterator(dq, tmpNode);
+			const_iterator ret(*this);
+			dq->step(ret.blk, ret.slot, n);
+			return ret;
 		}
-		const_iterator operator-(const int &n) const
+		const_iterator operator-(const difference_type &n) const
 		{
-			if (n < 0)
-				return (*this + (-n));
-			int res = n;
-			node *tmpNode = nd;
-			while (res > 0 && tmpNode->prev != nullptr)
-			{
-				--res;
-				tmpNode = tmpNode->prev;
-			}
-			if (res == 0)
-				return const_iterator(dq, tmpNode);
-			
-			--res;
-			block *tmpBlock = tmpNode->par->prev;
-			if (tmpBlock == nullptr)
-				throw invalid_iterator();
-			res -= tmpBlock->size;
-			while (res >= 0 && tmpBlock->prev != nullptr)
-			{
-				tmpBlock = tmpBlock->prev;
-				res -= tmpBlock->size;
-			}
-			res += tmpBlock->size;
-			
-			tmpNode = tmpBlock->listTail;
-			while (res > 0 && tmpNode->prev != nullptr)
-			{
-				--res;
-				tmpNode = tmpNode->prev;
-			}
-			if (res > 0)
-				throw invalid_iterator();
-			return const_iterator(dq, tmpNode);
+			const_iterator ret(*this);
+			dq->step(ret.blk, ret.slot, -n);
+			return ret;
 		}
 		// return th distance between two iterator,
 		// if these two iterators points to different vectors, throw invaild_iterator.
-		int operator-(const iterator &rhs) const
+		difference_type operator-(const iterator &rhs) const
 		{
 			if (dq != rhs.dq)
 				throw invalid_iterator();
-			int ret = 0, cur = 0;
-			for (block *i = dq->blockHead; i != nullptr; cur += i->size, i = i->succ)
-			{
-				if (nd->par == i || rhs.nd->par == i)
-				{
-					for (node *j = i->listHead; j != nullptr; ++cur, j = j->succ)
-					{
-						if (nd == j)
-							ret += cur;
-						if (rhs.nd == j)
-							ret -= cur;
-					}
-					cur -= i->size;
-				}
-			}
-			return ret;
+			return (difference_type) dq->position(blk, slot) - (difference_type) dq->position(rhs.blk, rhs.slot);
 		}
-		int operator-(const const_iterator &rhs) const
+		difference_type operator-(const const_iterator &rhs) const
 		{
 			if (dq != rhs.dq)
 				throw invalid_iterator();
-			int ret = 0, cur = 0;
-			for (block *i = dq->blockHead; i != nullptr; cur += i->size, i = i->succ)
-			{
-				if (nd->par == i || rhs.nd->par == i)
-				{
-					for (node *j = i->listHead; j != nullptr; ++cur, j = j->succ)
-					{
-						if (nd == j)
-							ret += cur;
-						if (rhs.nd == j)
-							ret -= cur;
-					}
-					cur -= i->size;
-				}
-			}
-			return ret;
+			return (difference_type) dq->position(blk, slot) - (difference_type) dq->position(rhs.blk, rhs.slot);
 		}
-		const_iterator operator+=(const int &n)
+		const_iterator& operator+=(const difference_type &n)
 		{
-			*this = (*this + n);
+			dq->step(blk, slot, n);
 			return *this;
 		}
-		const_iterator operator-=(const int &n)
+		const_iterator& operator-=(const difference_type &n)
 		{
-			*this = (*this - n);
+			dq->step(blk, slot, -n);
 			return *this;
 		}
 		/**
@@ -520,13 +778,8 @@ public:
 		 */
 		const_iterator operator++(int)
 		{
-			const_iterator ret(dq, nd);
-			if (nd->succ != nullptr)
-				nd = nd->succ;
-			else if (nd->par->succ == nullptr)
-				*this = dq->cend();
-			else
-				nd = nd->par->succ->listHead;
+			const_iterator ret(*this);
+			dq->next(blk, slot);
 			return ret;
 		}
 		/**
@@ -534,12 +787,7 @@ public:
 		 */
 		const_iterator& operator++()
 		{
-			if (nd->succ != nullptr)
-				nd = nd->succ;
-			else if (nd->par->succ == nullptr)
-				*this = dq->cend();
-			else
-				nd = nd->par->succ->listHead;
+			dq->next(blk, slot);
 			return *this;
 		}
 		/**
@@ -547,13 +795,8 @@ public:
 		 */
 		const_iterator operator--(int)
 		{
-			const_iterator ret(dq, nd);
-			if (nd->prev != nullptr)
-				nd = nd->prev;
-			else if (nd->par->prev == nullptr)
-				*this = dq->cend();
-			else
-				nd = nd->par->prev->listTail;
+			const_iterator ret(*this);
+			dq->prev(blk, slot);
 			return ret;
 		}
 		/**
@@ -561,12 +804,7 @@ public:
 		 */
 		const_iterator& operator--()
 		{
-			if (nd->prev != nullptr)
-				nd = nd->prev;
-			else if (nd->par->prev == nullptr)
-				*this = dq->cend();
-			else
-				nd = nd->par->prev->listTail;
+			dq->prev(blk, slot);
 			return *this;
 		}
 		/**
@@ -576,7 +814,7 @@ public:
 		{
 			if (*this == dq->cend())
 				throw invalid_iterator();
-			return *(nd->data);
+			return blk->data[slot];
 		}
 		/**
 		 * TODO it->field
@@ -585,29 +823,53 @@ public:
 		{
 			if (*this == dq->cend())
 				throw invalid_iterator();
-			return nd->data;
+			return &blk->data[slot];
+		}
+		const T& operator[](const difference_type &n) const
+		{
+			return *(*this + n);
 		}
 		/**
 		 * a operator to check whether two iterators are same (pointing to the same memory).
 		 */
 		bool operator==(const iterator &rhs) const
 		{
-			return (dq == rhs.dq) && (nd == rhs.nd);
+			return (dq == rhs.dq) && (blk == rhs.blk) && (slot == rhs.slot);
 		}
 		bool operator==(const const_iterator &rhs) const
 		{
-			return (dq == rhs.dq) && (nd == rhs.nd);
+			return (dq == rhs.dq) && (blk == rhs.blk) && (slot == rhs.slot);
 		}
 		/**
 		 * some other operator for iterator.
 		 */
 		bool operator!=(const iterator &rhs) const
 		{
-			return (dq != rhs.dq) || (nd != rhs.nd);
+			return !(*this == rhs);
 		}
 		bool operator!=(const const_iterator &rhs) const
 		{
-			return (dq != rhs.dq) || (nd != rhs.nd);
+			return !(*this == rhs);
+		}
+		bool operator<(const const_iterator &rhs) const
+		{
+			return *this - rhs < 0;
+		}
+		bool operator>(const const_iterator &rhs) const
+		{
+			return *this - rhs > 0;
+		}
+		bool operator<=(const const_iterator &rhs) const
+		{
+			return *this - rhs <= 0;
+		}
+		bool operator>=(const const_iterator &rhs) const
+		{
+			return *this - rhs >= 0;
+		}
+		friend const_iterator operator+(const difference_type &n, const const_iterator &rhs)
+		{
+			return rhs + n;
 		}
 	};
 	/**
@@ -615,55 +877,22 @@ public:
 	 */
 	deque()
 	{
-		blockHead = new block(1);
-		blockTail = blockHead;
-		blockHead->listHead = new node();
-		blockHead->listTail = blockHead->listHead;
-		blockHead->listHead->par = blockHead;
-		dataSize = 1;
+		init();
 	}
-	deque(const deque &other)
+	explicit deque(const Allocator &_alloc) : alloc(_alloc), blockAlloc(_alloc), tableAlloc(_alloc)
 	{
-		block *i = other.blockHead, **j = &blockHead, *pj = nullptr;
-		while (i != nullptr)
-		{
-			(*j) = new block(i->size);
-			
-			node *x = i->listHead, **y = &((*j)->listHead), *py = nullptr;
-			while (x != nullptr)
-			{
-				if (x->data != nullptr)
-					(*y) = new node(*(x->data));
-				else
-					(*y) = new node();
-				(*y)->prev = py;
-				py = (*y);
-				(*y)->par = (*j);
-				
-				y = &((*y)->succ);
-				x = x->succ;
-			}
-			
-			(*j)->prev = pj;
-			pj = (*j);
-			(*j)->listTail = py;
-			
-			j = &((*j)->succ);
-			i = i->succ;
-		}
-		blockTail = pj;
-		dataSize = other.dataSize;
+		init();
+	}
+	deque(const deque &other) : alloc(other.alloc), blockAlloc(other.blockAlloc), tableAlloc(other.tableAlloc)
+	{
+		copy(other);
 	}
 	/**
 	 * TODO Deconstructor
 	 */
 	~deque()
 	{
-		for (block *i = blockHead, *j; i != nullptr; i = j)
-		{
-			j = i->succ;
-			delete i;
-		}
+		release();
 	}
 	/**
 	 * TODO assignment operator
@@ -672,36 +901,16 @@ public:
 	{
 		if (this == &other)
 			return *this;
-		this->~deque();
-		block *i = other.blockHead, **j = &blockHead, *pj = nullptr;
-		while (i != nullptr)
-		{
-			(*j) = new block(i->size);
-			
-			node *x = i->listHead, **y = &((*j)->listHead), *py = nullptr;
-			while (x != nullptr)
-			{
-				if (x->data != nullptr)
-					(*y) = new node(*(x->data));
-				else
-					(*y) = new node();
-				(*y)->prev = py;
-				py = (*y);
-				(*y)->par = (*j);
-				
-				y = &((*y)->succ);
-				x = x->succ;
-			}
-			
-			(*j)->prev = pj;
-			pj = (*j);
-			(*j)->listTail = py;
-			
-			j = &((*j)->succ);
-			i = i->succ;
-		}
-		blockTail = pj;
-		dataSize = other.dataSize;
+		release();
+		try
+		{
+			copy(other);
+		}
+		catch (...)
+		{
+			init();
+			throw;
+		}
 		return *this;
 	}
 	/**
@@ -710,47 +919,21 @@ public:
 	 */
 	T & at(const size_t &pos)
 	{
-		if (pos < 0 || pos >= dataSize - 1)
+		if (pos >= dataSize)
 			throw index_out_of_bound();
-		int res = pos;
-		block *tmpBlock = blockHead;
-		res -= tmpBlock->size;
-		while (res >= 0)
-		{
-			tmpBlock = tmpBlock->succ;
-			res -= tmpBlock->size;
-		}
-		res += tmpBlock->size;
-		
-		node *tmpNode = tmpBlock->listHead;
-		while (res > 0)
-		{
-			--res;
-			tmpNode = tmpNode->succ;
-		}
-		return *(tmpNode->data);
+		block *blk;
+		size_t slot;
+		locate(pos, blk, slot);
+		return blk->data[slot];
 	}
 	const T & at(const size_t &pos) const
 	{
-		if (pos < 0 || pos >= dataSize - 1)
+		if (pos >= dataSize)
 			throw index_out_of_bound();
-		int res = pos;
-		block *tmpBlock = blockHead;
-		res -= tmpBlock->size;
-		while (res >= 0)
-		{
-			tmpBlock = tmpBlock->succ;
-			res -= tmpBlock->size;
-		}
-		res += tmpBlock->size;
-		
-		node *tmpNode = tmpBlock->listHead;
-		while (res > 0)
-		{
-			--res;
-			tmpNode = tmpNode->succ;
-		}
-		return *(tmpNode->data);
+		block *blk;
+		size_t slot;
+		locate(pos, blk, slot);
+		return blk->data[slot];
 	}
 	T & operator[](const size_t &pos)
 	{
@@ -768,7 +951,7 @@ public:
 	{
 		if (empty())
 			throw container_is_empty();
-		return *(blockHead->listHead->data);
+		return blockHead->data[blockHead->head];
 	}
 	/**
 	 * access the last element
@@ -778,62 +961,58 @@ public:
 	{
 		if (empty())
 			throw container_is_empty();
-			
-		node *ret = blockTail->listTail;
-		if (ret->prev != nullptr)
-			ret = ret->prev;
-		else
-			ret = ret->par->prev->listTail;
-		return *(ret->data);
+		return blockTail->data[blockTail->head + blockTail->size - 1];
 	}
 	/**
 	 * returns an iterator to the beginning.
 	 */
 	iterator begin()
 	{
-		return iterator(this, blockHead->listHead);
+		return iterator(this, blockHead, blockHead->head);
 	}
 	const_iterator cbegin() const
 	{
-		return const_iterator(this, blockHead->listHead);
+		return const_iterator(this, blockHead, blockHead->head);
 	}
 	/**
 	 * returns an iterator to the end.
 	 */
 	iterator end()
 	{
-		return iterator(this, blockTail->listTail);
+		return iterator(this, blockTail, blockTail->head + blockTail->size);
 	}
 	const_iterator cend() const
 	{
-		return const_iterator(this, blockTail->listTail);
+		return const_iterator(this, blockTail, blockTail->head + blockTail->size);
 	}
 	/**
 	 * checks whether the container is empty.
 	 */
 	bool empty() const
 	{
-		return dataSize == 1;
+		return dataSize == 0;
 	}
 	/**
 	 * returns the number of elements
 	 */
 	size_t size() const
 	{
-		return dataSize - 1;
+		return dataSize;
+	}
+	/**
+	 * returns the allocator of the elements.
+	 */
+	Allocator get_allocator() const
+	{
+		return alloc;
 	}
 	/**
 	 * clears the contents
 	 */
 	void clear()
 	{
-		this->~deque();
-		blockHead = new block(1);
-		blockTail = blockHead;
-		blockHead->listHead = new node();
-		blockHead->listTail = blockHead->listHead;
-		blockHead->listHead->par = blockHead;
-		dataSize = 1;
+		release();
+		init();
 	}
 	/**
 	 * inserts elements at the specified locat on in the container.
@@ -842,25 +1021,93 @@ public:
 	 *     throw if the iterator is invalid or it point to a wrong place.
 	 */
 	iterator insert(iterator pos, const T &value)
+	{
+		return emplace(pos, value);
+	}
+	iterator insert(iterator pos, T &&value)
+	{
+		return emplace(pos, std::move(value));
+	}
+	/**
+	 * constructs an element in place before pos, args are forwarded to the constructor of T.
+	 * returns an iterator pointing to the new element.
+	 * at either end of a block with room there (or of the deque, where a new block is
+	 *   started) no element is moved; otherwise the new element is built first, since
+	 *   args may refer to an element of this deque.
+	 */
+	template<class... Args>
+	iterator emplace(iterator pos, Args&&... args)
 	{
 		if (pos.dq != this)
 			throw invalid_iterator();
-		node *tmpNode = new node(value);
-		tmpNode->par = pos.nd->par;
-		tmpNode->prev = pos.nd->prev;
-		tmpNode->succ = pos.nd;
-		if (pos.nd->prev != nullptr)
-			pos.nd->prev->succ = tmpNode;
+		block *blk = pos.blk;
+		size_t ind = pos.slot - blk->head, slot;
+		if (ind == 0 && blk->head == 0 && blk == blockHead && blk->size != 0)
+		{
+			reserve();
+			blk = newBlock(capacity(), capacity());
+			try
+			{
+				new(&blk->data[blk->cap - 1]) T(std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				dispose(blk);
+				throw;
+			}
+			blk->start = blockHead->start;
+			link(blk, 0);
+			slot = --blk->head;
+		}
+		else if (ind == blk->size && blk->head + blk->size == blk->cap)
+		{
+			reserve();
+			blk = newBlock(capacity(), 0);
+			try
+			{
+				new(&blk->data[0]) T(std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				dispose(blk);
+				throw;
+			}
+			blk->start = blockTail->start + blockTail->size;
+			link(blk, tableSize);
+			slot = 0;
+		}
+		else if (ind == 0 && blk->head != 0)
+		{
+			new(&blk->data[blk->head - 1]) T(std::forward<Args>(args)...);
+			slot = --blk->head;
+		}
+		else if (ind == blk->size && blk->head + blk->size != blk->cap)
+		{
+			new(&blk->data[blk->head + blk->size]) T(std::forward<Args>(args)...);
+			slot = blk->head + blk->size;
+		}
 		else
-			pos.nd->par->listHead = tmpNode;
-		pos.nd->prev = tmpNode;
-		
+		{
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type buf;
+			T *tmp = new(&buf) T(std::forward<Args>(args)...);
+			try
+			{
+				slot = gap(blk, ind);
+			}
+			catch (...)
+			{
+				tmp->~T();
+				throw;
+			}
+			relocate(blk->data + slot, tmp, 1);
+			relabel(blk, 1);
+			++dataSize;
+			return iterator(this, blk, slot);
+		}
+		++blk->size;
+		relabel(blk, 1);
 		++dataSize;
-		++pos.nd->par->size;
-		
-		maintain(pos.nd->par);
-		
-		return pos - 1;
+		return iterator(this, blk, slot);
 	}
 	/**
 	 * removes specified element at pos.
@@ -870,25 +1117,12 @@ public:
 	 */
 	iterator erase(iterator pos)
 	{
-		if (pos == this->end() || pos.dq != this)
+		if (pos.dq != this || pos == this->end())
 			throw invalid_iterator();
-		iterator ret = pos + 1;
-		if (pos.nd->prev != nullptr)
-			pos.nd->prev->succ = pos.nd->succ;
-		else
-			pos.nd->par->listHead = pos.nd->succ;
-		if (pos.nd->succ != nullptr)
-			pos.nd->succ->prev = pos.nd->prev;
-		else
-			pos.nd->par->listTail = pos.nd->prev;
-		
-		--dataSize;
-		--pos.nd->par->size;
-		maintain(pos.nd->par);
-		
-		delete pos.nd;
-		
-		return ret;
+		block *blk = pos.blk;
+		size_t ind = pos.slot - blk->head;
+		remove(blk, ind, true);
+		return iterator(this, blk, blk->head + ind);
 	}
 	/**
 	 * adds an element to the end
@@ -897,13 +1131,29 @@ public:
 	{
 		insert(this->end(), value);
 	}
+	void push_back(T &&value)
+	{
+		insert(this->end(), std::move(value));
+	}
+	/**
+	 * constructs an element in place at the end.
+	 */
+	template<class... Args>
+	void emplace_back(Args&&... args)
+	{
+		emplace(this->end(), std::forward<Args>(args)...);
+	}
 	/**
 	 * removes the last element
 	 *     throw when the container is empty.
 	 */
 	void pop_back()
 	{
-		erase(this->end() - 1);
+		if (empty())
+			throw container_is_empty();
+		block *blk = blockTail;
+		size_t ind = blk->size - 1;
+		remove(blk, ind, false);
 	}
 	/**
 	 * inserts an element to the beginning.
@@ -912,16 +1162,32 @@ public:
 	{
 		insert(this->begin(), value);
 	}
+	void push_front(T &&value)
+	{
+		insert(this->begin(), std::move(value));
+	}
+	/**
+	 * constructs an element in place at the beginning.
+	 */
+	template<class... Args>
+	void emplace_front(Args&&... args)
+	{
+		emplace(this->begin(), std::forward<Args>(args)...);
+	}
 	/**
 	 * removes the first element.
 	 *     throw when the container is empty.
 	 */
 	void pop_front()
 	{
-		erase(this->begin());
+		if (empty())
+			throw container_is_empty();
+		block *blk = blockHead;
+		size_t ind = 0;
+		remove(blk, ind, false);
 	}
 };
 
 }
 
-#endif
\ No newline at end of file
+#endif
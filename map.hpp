@@ -7,105 +7,326 @@
 // only for std::less<T>
 #include <functional>
 #include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include "utility.hpp"
 #include "exceptions.hpp"
 
 namespace sjtu
 {
 
-template<class Key,	class T, class Compare = std::less<Key> >
+/**
+ * whether Compare has a member int compare(const Key &, const K &) const, see map.
+ */
+template<class Compare, class Key, class K, class = void>
+struct has_three_way_compare : std::false_type {};
+template<class Compare, class Key, class K>
+struct has_three_way_compare<Compare, Key, K, decltype(void(std::declval<const Compare &>().compare(std::declval<const Key &>(), std::declval<const K &>())))> : std::true_type {};
+
+/**
+ * the tree nodes are obtained from Allocator (rebound to the node type).
+ * besides the less-than operator(), Compare may provide a three-way
+ *   int compare(const Key &a, const Key &b) const (negative, zero or positive as a is
+ *   less than, equivalent to or greater than b, like std::string::compare);
+ *   the lookups then call it once per level and stop at the equivalent key.
+ */
+template<class Key,	class T, class Compare = std::less<Key>, class Allocator = std::allocator<pair<const Key, T> > >
 class map
 {
 public:
 	typedef pair<const Key, T> value_type;
 	//
 private:
-	class node
+	/**
+	 * the links of a tree node.
+	 * the sentinel head is a bare node_base: head.ch[0] is the root, head.ch[1] and
+	 *   head.par are always nullptr, and end() points to it.
+	 * adj[0]/adj[1] thread the nodes into a circular list in key order through head,
+	 *   so head.adj[1] is the first node and head.adj[0] is the last one.
+	 * size is the number of nodes in the subtree, for rank and select.
+	 */
+	class node_base
 	{
 		friend map;
 	private:
-		value_type value;
-		node *ch[2], *par;
+		node_base *ch[2], *par, *adj[2];
+		size_t size;
 		bool color;
 	public:
-		node(const value_type &_value) : value(_value), color(0), par(nullptr)
+		node_base() : par(nullptr), size(0), color(0)
 		{
 			ch[0] = ch[1] = nullptr;
+			adj[0] = adj[1] = nullptr;
 		}
-		node(const Key &other) : value(other, T()), color(0), par(nullptr)
+	};
+	class node : public node_base
+	{
+		friend map;
+	private:
+		value_type value;
+	public:
+		node(const value_type &_value) : value(_value) {}
+		node(value_type &&_value) : value(std::move(_value)) {}
+		node(const Key &other) : value(other, T()) {}
+		//construct the value from (key, mapped value)
+		template<class K, class V>
+		node(K &&key, V &&val) : value(std::forward<K>(key), std::forward<V>(val)) {}
+		~node()
 		{
-			ch[0] = ch[1] = nullptr;
 		}
-		~node()
+	};
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<node> node_allocator;
+	typedef std::allocator_traits<node_allocator> node_traits;
+	/**
+	 * a slab allocator of nodes.
+	 * nodes are carved from chunks obtained from the node allocator, freed nodes are
+	 *   kept in a free list for reuse, and the chunks are only returned by release().
+	 * split_at hands nodes to another map without copying them, so a pool may be
+	 *   shared: refs counts its maps, and the last one frees it.
+	 */
+	class pool
+	{
+		friend map;
+	private:
+		//kept in the first slot of every chunk
+		struct chunk
 		{
+			node *next;
+			size_t size;
+		};
+		static const size_t minChunk = 32, maxChunk = 4096;
+		node_allocator alloc;
+		node *chunks, *freeList, *cur, *last;
+		size_t chunkSize, refs, freeCount;
+
+		pool(const pool &);
+		pool & operator=(const pool &);
+		//start a chunk of size slots, the rest of the current one goes to the free list
+		void grow(size_t size)
+		{
+			node *tmp = node_traits::allocate(alloc, size);
+			new(tmp) chunk{chunks, size};
+			while (cur != last)
+				deallocate(cur++);
+			chunks = tmp;
+			cur = tmp + 1;
+			last = tmp + size;
+			if (chunkSize < maxChunk)
+				chunkSize *= 2;
+		}
+	public:
+		pool(const node_allocator &_alloc = node_allocator()) : alloc(_alloc), chunks(nullptr), freeList(nullptr), cur(nullptr), last(nullptr), chunkSize(minChunk), refs(1), freeCount(0) {}
+		~pool()
+		{
+			release();
+		}
+		node *allocate()
+		{
+			if (freeList != nullptr)
+			{
+				node *ret = freeList;
+				freeList = *reinterpret_cast<node**>(ret);
+				--freeCount;
+				return ret;
+			}
+			if (cur == last)
+				grow(chunkSize);
+			return cur++;
+		}
+		//make the next n calls of allocate() take at most one new chunk
+		void reserve(size_t n)
+		{
+			size_t room = freeCount + (last - cur);
+			if (room < n)
+				grow(n - room + 1 > chunkSize ? n - room + 1 : chunkSize);
+		}
+		void deallocate(node *x)
+		{
+			new(x) node*(freeList);
+			freeList = x;
+			++freeCount;
+		}
+		//return all chunks, every node in them must have been destroyed
+		void release()
+		{
+			for (node *i = chunks, *j; i != nullptr; i = j)
+			{
+				chunk *c = reinterpret_cast<chunk*>(i);
+				j = c->next;
+				node_traits::deallocate(alloc, i, c->size);
+			}
+			chunks = freeList = cur = last = nullptr;
+			chunkSize = minChunk;
+			freeCount = 0;
 		}
 	};
-	node *root;
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<pool> pool_allocator;
+	typedef std::allocator_traits<pool_allocator> pool_traits;
+	node_base head;
 	size_t dataSize;
 	Compare cc;
+	pool *memory;
+
+	static pool *newPool(const node_allocator &alloc)
+	{
+		pool_allocator pa(alloc);
+		pool *ret = pool_traits::allocate(pa, 1);
+		new(ret) pool(alloc);
+		return ret;
+	}
+	//drop this map's reference to the pool, every node of this map must have been disposed
+	void leave()
+	{
+		if (--memory->refs != 0)
+			return;
+		pool_allocator pa(memory->alloc);
+		memory->~pool();
+		pool_traits::deallocate(pa, memory, 1);
+	}
+
+	/**
+	 * take a node from the pool and construct it from args.
+	 */
+	template<class... Args>
+	node *create(Args&&... args)
+	{
+		node *ret = memory->allocate();
+		try
+		{
+			new(ret) node(std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			memory->deallocate(ret);
+			throw;
+		}
+		return ret;
+	}
+	void dispose(node *x)
+	{
+		x->~node();
+		memory->deallocate(x);
+	}
 
-	bool equal(const Key &x, const Key &y) const
+	static value_type & valueOf(node_base *x)
+	{
+		return static_cast<node*>(x)->value;
+	}
+	static const Key & keyOf(node_base *x)
+	{
+		return static_cast<node*>(x)->value.first;
+	}
+	node_base *header() const
+	{
+		return const_cast<node_base*>(&head);
+	}
+	void init()
+	{
+		head.ch[0] = nullptr;
+		head.adj[0] = head.adj[1] = &head;
+		dataSize = 0;
+	}
+	//K is Key, or any type Compare accepts if it is transparent
+	template<class K>
+	using threeWay = has_three_way_compare<Compare, Key, K>;
+	template<class K>
+	int cmp(const Key &x, const K &y, std::true_type) const
+	{
+		return cc.compare(x, y);
+	}
+	template<class K>
+	int cmp(const Key &x, const K &y, std::false_type) const
 	{
-		return !cc(x, y) && !cc(y, x);
+		return cc(x, y) ? -1 : cc(y, x);
 	}
-	bool chlr(node *x) const
+	//negative, zero or positive as x is less than, equivalent to or greater than y
+	template<class K>
+	int cmp(const Key &x, const K &y) const
+	{
+		return cmp(x, y, threeWay<K>());
+	}
+	static size_t sizeOf(node_base *x)
+	{
+		return x == nullptr ? 0 : x->size;
+	}
+	//the number of nodes before x, dataSize if x is head
+	size_t order(node_base *x) const
+	{
+		if (x == &head)
+			return dataSize;
+		size_t ret = sizeOf(x->ch[0]);
+		for (; x->par != &head; x = x->par)
+			if (chlr(x))
+				ret += sizeOf(x->par->ch[0]) + 1;
+		return ret;
+	}
+	//the root is head.ch[0], so chlr(root) == 0
+	bool chlr(node_base *x) const
 	{
 		return x->par->ch[1] == x;
 	}
 	//0-left 1-right
-	void rotate(node *x, bool t)
+	void rotate(node_base *x, bool t)
 	{
-		node *y = x->ch[t ^ 1];
+		node_base *y = x->ch[t ^ 1];
 		x->ch[t ^ 1] = y->ch[t];
 		if (y->ch[t] != nullptr)
 			y->ch[t]->par = x;
-		if (x == root)
-			root = y;
-		else
-			x->par->ch[chlr(x)] = y;
+		x->par->ch[chlr(x)] = y;
 		y->par = x->par;
 		y->ch[t] = x;
 		x->par = y;
+		y->size = x->size;
+		x->size = sizeOf(x->ch[0]) + sizeOf(x->ch[1]) + 1;
 	}
-	node *prev(node *x) const
+	/**
+	 * the previous node of x (the last one if x is head).
+	 * throw invalid_iterator if x is the first one.
+	 */
+	node_base *prev(node_base *x) const
 	{
-		if (x->ch[0] == nullptr)
-		{
-			while (x != root && chlr(x) == 0)
-				x = x->par;
-			return x->par;
-		}
-		else
-		{
-			x = x->ch[0];
-			while (x->ch[1] != nullptr)
-				x = x->ch[1];
-			return x;
-		}
+		if (x == head.adj[1])
+			throw invalid_iterator();
+		return x->adj[0];
 	}
-	node *succ(node *x) const
+	/**
+	 * the next node of x (head if x is the last one).
+	 * throw invalid_iterator if x is head.
+	 */
+	node_base *succ(node_base *x) const
 	{
-		if (x->ch[1] == nullptr)
-		{
-			while (x != root && chlr(x) == 1)
-				x = x->par;
-			return x->par;
-		}
-		else
-		{
-			x = x->ch[1];
-			while (x->ch[0] != nullptr)
-				x = x->ch[0];
-			return x;
-		}
+		if (x == &head)
+			throw invalid_iterator();
+		return x->adj[1];
+	}
+	//put x into the list on the t side of y
+	static void thread(node_base *x, node_base *y, bool t)
+	{
+		node_base *z = y->adj[t];
+		x->adj[t] = z;
+		x->adj[t ^ 1] = y;
+		y->adj[t] = x;
+		z->adj[t ^ 1] = x;
 	}
-	void fixInsert(node *z)
+	void fixInsert(node_base *z)
+	{
+		fixRed(z);
+		head.ch[0]->color = 0;
+	}
+	/**
+	 * repair the red z under a red parent, the root may be left red.
+	 * the parent of the root must be black (head, or the stand-in of join).
+	 */
+	void fixRed(node_base *z)
 	{
 		//if z's deep = 2, then z->par(root)->color = 0
-		while (z->par != nullptr && z->par->color == 1)
+		//head is black, so the loop stops below the root
+		while (z->par->color == 1)
 		{
 			bool t = chlr(z->par);
-			node *y = z->par->par->ch[t ^ 1];
+			node_base *y = z->par->par->ch[t ^ 1];
 			if (y != nullptr && y->color == 1)
 			{
 				z->par->color = 0;
@@ -125,15 +346,14 @@ private:
 				rotate(z->par->par, t ^ 1);
 			}
 		}
-		root->color = 0;
 	}
-	void fixDelete(node *x, node *xp)
+	void fixDelete(node_base *x, node_base *xp)
 	{
-		while ((x == nullptr || x->color == 0) && x != root)
+		while ((x == nullptr || x->color == 0) && x != head.ch[0])
 		{
 			bool t = xp->ch[1] == x;
 			//x must have a brother
-			node *w = xp->ch[t ^ 1];
+			node_base *w = xp->ch[t ^ 1];
 			if (w->color == 1)
 			{
 				w->color = 0;
@@ -161,33 +381,557 @@ private:
 				xp->color = 0;
 				w->ch[t ^ 1]->color = 0;
 				rotate(xp, t);
-				x = root;
+				x = head.ch[0];
 			}
 		}
 		if (x != nullptr)
 			x->color = 0;
 	}
-	void cra(node **cur, node *other)
+	/**
+	 * find the node whose key is equivalent to key.
+	 * if there is no such node, return the empty child pointer where it should be
+	 *   linked, and set p to the parent of that position.
+	 */
+	node_base **locate(const Key &key, node_base *&p)
+	{
+		return locate(key, p, threeWay<Key>());
+	}
+	node_base **locate(const Key &key, node_base *&p, std::true_type)
+	{
+		node_base **cur = &head.ch[0];
+		p = &head;
+		while (*cur != nullptr)
+		{
+			int c = cc.compare(keyOf(*cur), key);
+			if (c == 0)
+				return cur;
+			p = *cur;
+			cur = &((*cur)->ch[c < 0]);
+		}
+		return cur;
+	}
+	/**
+	 * one cc per level: go right unless key is less, so the last node passed to the right
+	 *   is the greatest one not greater than key, and only it is checked for equivalence.
+	 */
+	node_base **locate(const Key &key, node_base *&p, std::false_type)
+	{
+		node_base **cur = &head.ch[0], *last = nullptr;
+		p = &head;
+		while (*cur != nullptr)
+		{
+			p = *cur;
+			bool t = !cc(key, keyOf(p));
+			if (t)
+				last = p;
+			cur = &p->ch[t];
+		}
+		if (last != nullptr && !cc(keyOf(last), key))
+			return slotOf(last);
+		return cur;
+	}
+	//the position holding x
+	node_base **slotOf(node_base *x)
+	{
+		return &x->par->ch[chlr(x)];
+	}
+	/**
+	 * locate key, trying the position just before hint first.
+	 * if key falls between hint and the node before it, no descent is needed:
+	 *   the new node becomes the left child of hint or the right child of that node,
+	 *   whichever is empty.
+	 * p is set as by locate(key, p), to the parent of the returned position.
+	 */
+	node_base **locate(node_base *hint, const Key &key, node_base *&p)
+	{
+		node_base *y = hint->adj[0];
+		if (hint != &head)
+		{
+			if (cc(keyOf(hint), key))
+				return locate(key, p);
+			if (!cc(key, keyOf(hint)))
+			{
+				p = hint->par;
+				return slotOf(hint);
+			}
+		}
+		if (y != &head)
+		{
+			if (cc(key, keyOf(y)))
+				return locate(key, p);
+			if (!cc(keyOf(y), key))
+			{
+				p = y->par;
+				return slotOf(y);
+			}
+		}
+		if (hint != &head && hint->ch[0] == nullptr)
+		{
+			p = hint;
+			return &hint->ch[0];
+		}
+		//y is the last node, or the last one of the left subtree of hint, or head if empty
+		p = y;
+		return y == &head ? &head.ch[0] : &y->ch[1];
+	}
+	/**
+	 * link the new node x to the empty position cur (found by locate) and rebalance.
+	 */
+	node_base *link(node_base **cur, node_base *p, node_base *x)
+	{
+		*cur = x;
+		x->par = p;
+		x->color = 1;
+		x->size = 1;
+		for (node_base *q = p; q != &head; q = q->par)
+			++q->size;
+		//a left child comes just before its parent, a right child just after
+		thread(x, p, cur == &p->ch[1]);
+		++dataSize;
+		fixInsert(x);
+		return x;
+	}
+    //destroy every node, following the list instead of the tree
+    void del()
+    {
+    	for (node_base *x = head.adj[1], *y; x != &head; x = y)
+    	{
+    		y = x->adj[1];
+    		dispose(static_cast<node*>(x));
+    	}
+    }
+    //the first node whose key is not less than key (greater than key if upper), head if none
+    template<class K>
+    node_base *bound(const K &key, bool upper) const
+    {
+    	node_base *cur = head.ch[0], *ret = header();
+    	while (cur != nullptr)
+    	{
+    		if (upper ? cc(key, keyOf(cur)) : !cc(keyOf(cur), key))
+    		{
+    			ret = cur;
+    			cur = cur->ch[0];
+    		}
+    		else
+    			cur = cur->ch[1];
+    	}
+    	return ret;
+    }
+    //build a balanced subtree of the next n nodes in the list from cur
+    node_base *build(node_base *&cur, size_t n, size_t depth, size_t redDepth)
+    {
+    	if (n == 0)
+    		return nullptr;
+    	node_base *l = build(cur, (n - 1) / 2, depth + 1, redDepth), *x = cur;
+    	cur = cur->adj[1];
+    	x->ch[0] = l;
+    	if (l != nullptr)
+    		l->par = x;
+    	x->ch[1] = build(cur, n - 1 - (n - 1) / 2, depth + 1, redDepth);
+    	if (x->ch[1] != nullptr)
+    		x->ch[1]->par = x;
+    	x->size = n;
+    	x->color = depth == redDepth;
+    	return x;
+    }
+    /**
+     * make the tree of the dataSize nodes in the list, without any rotation.
+     * the levels above redDepth are full and black, and the nodes on the last,
+     *   incomplete level (if any) are red, so every path has the same black height.
+     */
+    void rebuild()
+    {
+    	size_t redDepth = 0;
+    	while ((size_t(2) << redDepth) <= dataSize + 1)
+    		++redDepth;
+    	node_base *cur = head.adj[1];
+    	head.ch[0] = build(cur, dataSize, 0, redDepth);
+    	if (head.ch[0] != nullptr)
+    		head.ch[0]->par = &head;
+    }
+    //the node with key, nullptr if none
+    template<class K>
+    node_base *search(const K &key) const
+    {
+    	return search(key, threeWay<K>());
+    }
+    template<class K>
+    node_base *search(const K &key, std::true_type) const
+    {
+    	node_base *cur = head.ch[0];
+    	while (cur != nullptr)
+    	{
+    		int c = cc.compare(keyOf(cur), key);
+    		if (c == 0)
+    			return cur;
+    		cur = cur->ch[c < 0];
+    	}
+    	return nullptr;
+    }
+    //the lower bound with one cc per level, then a single check for equivalence
+    template<class K>
+    node_base *search(const K &key, std::false_type) const
+    {
+    	node_base *ret = bound(key, 0);
+    	return ret != &head && !cc(key, keyOf(ret)) ? ret : nullptr;
+    }
+    //the k-th node (counting from 0)
+    node_base *select(size_t k) const
+    {
+    	if (k >= dataSize)
+    		throw index_out_of_bound();
+    	node_base *cur = head.ch[0];
+    	while (k != sizeOf(cur->ch[0]))
+    	{
+    		if (k < sizeOf(cur->ch[0]))
+    			cur = cur->ch[0];
+    		else
+    		{
+    			k -= sizeOf(cur->ch[0]) + 1;
+    			cur = cur->ch[1];
+    		}
+    	}
+    	return cur;
+    }
+    //the end of the range of key, given its lower bound
+    template<class K>
+    node_base *rangeEnd(node_base *lo, const K &key) const
+    {
+    	if (lo != &head && !cc(key, keyOf(lo)))
+    		return lo->adj[1];
+    	return lo;
+    }
+    //a copy of s under parent par
+    node_base *clone(node_base *s, node_base *par)
+    {
+    	node_base *x = create(valueOf(s));
+    	x->color = s->color;
+    	x->size = s->size;
+    	x->par = par;
+    	return x;
+    }
+    /**
+     * copy the tree of other, the tree of this should be empty.
+     * the nodes of other are visited in order with the parent links instead of
+     *   recursion: s walks the tree of other and d the copy at the same place.
+     * the freed nodes of the pool are reused first, the rest come from one new chunk.
+     */
+    void copy(const map &other)
+    {
+    	init();
+    	size_t n = other.dataSize;
+    	if (n == 0)
+    		return;
+    	memory->reserve(n);
+    	try
+    	{
+    		node_base *s = other.head.ch[0], *d = clone(s, &head);
+    		head.ch[0] = d;
+    		while (true)
+    		{
+    			while (s->ch[0] != nullptr)
+    			{
+    				s = s->ch[0];
+    				d = d->ch[0] = clone(s, d);
+    			}
+    			while (true)
+    			{
+    				thread(d, &head, 0);
+    				if (s->ch[1] != nullptr)
+    				{
+    					s = s->ch[1];
+    					d = d->ch[1] = clone(s, d);
+    					break;
+    				}
+    				//climb over the subtrees already copied, the next node is the parent of a left child
+    				while (chlr(s))
+    				{
+    					s = s->par;
+    					d = d->par;
+    				}
+    				if (s->par == &other.head)
+    				{
+    					dataSize = n;
+    					return;
+    				}
+    				s = s->par;
+    				d = d->par;
+    			}
+    		}
+    	}
+    	catch (...)
+    	{
+    		//free the partial copy from the leaves up
+    		node_base *x = head.ch[0];
+    		while (x != nullptr)
+    		{
+    			if (x->ch[0] != nullptr)
+    				x = x->ch[0];
+    			else if (x->ch[1] != nullptr)
+    				x = x->ch[1];
+    			else
+    			{
+    				node_base *p = x->par;
+    				p->ch[p->ch[1] == x] = nullptr;
+    				dispose(static_cast<node*>(x));
+    				x = p == &head ? nullptr : p;
+    			}
+    		}
+    		init();
+    		throw;
+    	}
+    }
+    //move the elements of other into this, which should be empty
+    void take(map &other)
+    {
+    	if (other.dataSize == 0)
+    		return;
+    	head.ch[0] = other.head.ch[0];
+    	head.ch[0]->par = &head;
+    	head.adj[0] = other.head.adj[0];
+    	head.adj[1] = other.head.adj[1];
+    	head.adj[0]->adj[1] = head.adj[1]->adj[0] = &head;
+    	dataSize = other.dataSize;
+    	other.init();
+    }
+    /**
+     * join and split work on detached subtrees (the parent of the root is ignored).
+     * bh is the black height of a subtree: the black nodes on a path down from its root,
+     *   counting the root if black, so a child of x has bh(x) - (x is black).
+     * they only reshape the tree: the list and dataSize are left to the callers.
+     */
+    //the detached tree of this map, its black height in bh
+    node_base *detach(size_t &bh)
+    {
+    	bh = 0;
+    	for (node_base *x = head.ch[0]; x != nullptr; x = x->ch[0])
+    		bh += x->color == 0;
+    	return head.ch[0];
+    }
+    void attach(node_base *t)
+    {
+    	head.ch[0] = t;
+    	if (t != nullptr)
+    	{
+    		t->par = &head;
+    		t->color = 0;
+    	}
+    }
+    /**
+     * the tree of l, x, r, where the keys of l are less than that of x and the keys of r greater.
+     * x is hung on the right spine of l (or the left spine of r, whichever is higher) at the
+     *   first black node as high as the other tree, and the red-red violation is repaired
+     *   upwards, in O(|bl - br| + 1).
+     */
+    node_base *join(node_base *l, size_t bl, node_base *x, node_base *r, size_t br, size_t &bh)
+    {
+    	if (l != nullptr && l->color == 1)
+    	{
+    		l->color = 0;
+    		++bl;
+    	}
+    	if (r != nullptr && r->color == 1)
+    	{
+    		r->color = 0;
+    		++br;
+    	}
+    	if (bl == br)
+    	{
+    		x->ch[0] = l;
+    		x->ch[1] = r;
+    		if (l != nullptr)
+    			l->par = x;
+    		if (r != nullptr)
+    			r->par = x;
+    		x->size = sizeOf(l) + sizeOf(r) + 1;
+    		x->color = 0;
+    		bh = bl + 1;
+    		return x;
+    	}
+    	//t = 0: x goes down the right spine of l, t = 1: down the left spine of r
+    	bool t = bl < br;
+    	node_base *big = t ? r : l, *small = t ? l : r;
+    	size_t b = t ? br : bl, target = t ? bl : br;
+    	bh = b;
+    	node_base top;
+    	top.ch[0] = big;
+    	big->par = &top;
+    	node_base *p = &top, *y = big;
+    	while (y != nullptr && (y->color == 1 || b != target))
+    	{
+    		b -= y->color == 0;
+    		p = y;
+    		y = y->ch[t ^ 1];
+    	}
+    	x->ch[t] = y;
+    	x->ch[t ^ 1] = small;
+    	if (y != nullptr)
+    		y->par = x;
+    	if (small != nullptr)
+    		small->par = x;
+    	x->size = sizeOf(y) + sizeOf(small) + 1;
+    	x->color = 1;
+    	p->ch[t ^ 1] = x;
+    	x->par = p;
+    	for (node_base *q = p; q != &top; q = q->par)
+    		q->size += sizeOf(small) + 1;
+    	fixRed(x);
+    	node_base *ret = top.ch[0];
+    	if (ret->color == 1)
+    	{
+    		ret->color = 0;
+    		++bh;
+    	}
+    	return ret;
+    }
+    /**
+     * split t by key into l (less than key), m (the node with key, nullptr if none) and r.
+     * pred is the last node of l met on the way down, which is the last one of l if m is
+     *   nullptr, or nullptr if l is empty then.
+     * O(log n): the subtrees hanging off the search path are joined back level by level.
+     */
+    template<class K>
+    void split(node_base *t, size_t bt, const K &key, node_base *&l, size_t &bl, node_base *&m, node_base *&r, size_t &br, node_base *&pred)
     {
-    	if (other == nullptr)
+    	if (t == nullptr)
+    	{
+    		l = m = r = pred = nullptr;
+    		bl = br = 0;
     		return;
-    	(*cur) = new node(other->value);
-    	
-	    (*cur)->color = other->color;
-	    cra(&((*cur)->ch[0]), other->ch[0]);
-	    if ((*cur)->ch[0] != nullptr)
-		    (*cur)->ch[0]->par = (*cur);
-	    cra(&((*cur)->ch[1]), other->ch[1]);
-	   	if ((*cur)->ch[1] != nullptr)
-	   		(*cur)->ch[1]->par = (*cur);
+    	}
+    	size_t bc = bt - (t->color == 0);
+    	node_base *a = t->ch[0], *b = t->ch[1];
+    	int c = cmp(keyOf(t), key);
+    	if (c > 0)
+    	{
+    		split(a, bc, key, l, bl, m, r, br, pred);
+    		r = join(r, br, t, b, bc, br);
+    	}
+    	else if (c < 0)
+    	{
+    		split(b, bc, key, l, bl, m, r, br, pred);
+    		if (pred == nullptr)
+    			pred = t;
+    		l = join(a, bc, t, l, bl, bl);
+    	}
+    	else
+    	{
+    		l = a;
+    		r = b;
+    		bl = br = bc;
+    		m = t;
+    		pred = nullptr;
+    	}
     }
-    void del(node *cur)
+    //take the last node of the non-empty t out into x
+    node_base *popLast(node_base *t, size_t bt, node_base *&x, size_t &bh)
     {
-    	if (cur == nullptr)
+    	size_t bc = bt - (t->color == 0);
+    	node_base *a = t->ch[0], *b = t->ch[1];
+    	if (b == nullptr)
+    	{
+    		x = t;
+    		bh = bc;
+    		return a;
+    	}
+    	b = popLast(b, bc, x, bh);
+    	return join(a, bc, t, b, bh, bh);
+    }
+    //join l and r without a middle node
+    node_base *concat(node_base *l, size_t bl, node_base *r, size_t br, size_t &bh)
+    {
+    	if (l == nullptr || r == nullptr)
+    	{
+    		bh = l == nullptr ? br : bl;
+    		return l == nullptr ? r : l;
+    	}
+    	node_base *x;
+    	l = popLast(l, bl, x, bl);
+    	return join(l, bl, x, r, br, bh);
+    }
+    //unlink every node of t from the list and dispose it
+    void drop(node_base *t)
+    {
+    	if (t == nullptr)
     		return;
-    	del(cur->ch[0]);
-    	del(cur->ch[1]);
-    	delete cur;
+    	drop(t->ch[0]);
+    	drop(t->ch[1]);
+    	t->adj[0]->adj[1] = t->adj[1];
+    	t->adj[1]->adj[0] = t->adj[0];
+    	--dataSize;
+    	dispose(static_cast<node*>(t));
+    }
+    /**
+     * the union of t and copies of the nodes of o, a subtree of another map.
+     * t is split at the key of the root of o, and the halves are merged with the
+     *   subtrees of o recursively; lo is the node before the keys of t in the list
+     *   (head if none), so that a new node can be threaded after its predecessor.
+     */
+    node_base *unite(node_base *t, size_t bt, node_base *o, node_base *lo, size_t &bh)
+    {
+    	if (o == nullptr)
+    	{
+    		bh = bt;
+    		return t;
+    	}
+    	node_base *l, *m, *r, *pred;
+    	size_t bl, br;
+    	split(t, bt, keyOf(o), l, bl, m, r, br, pred);
+    	if (m == nullptr)
+    	{
+    		m = create(valueOf(o));
+    		thread(m, pred == nullptr ? lo : pred, 1);
+    		++dataSize;
+    	}
+    	l = unite(l, bl, o->ch[0], lo, bl);
+    	r = unite(r, br, o->ch[1], m, br);
+    	return join(l, bl, m, r, br, bh);
+    }
+    //the nodes of t whose keys are in o, the others are disposed
+    node_base *meet(node_base *t, size_t bt, node_base *o, size_t &bh)
+    {
+    	if (t == nullptr || o == nullptr)
+    	{
+    		drop(t);
+    		bh = 0;
+    		return nullptr;
+    	}
+    	node_base *l, *m, *r, *pred;
+    	size_t bl, br;
+    	split(t, bt, keyOf(o), l, bl, m, r, br, pred);
+    	l = meet(l, bl, o->ch[0], bl);
+    	r = meet(r, br, o->ch[1], br);
+    	if (m == nullptr)
+    		return concat(l, bl, r, br, bh);
+    	return join(l, bl, m, r, br, bh);
+    }
+    //the nodes of t whose keys are not in o, the others are disposed
+    node_base *subtract(node_base *t, size_t bt, node_base *o, size_t &bh)
+    {
+    	if (t == nullptr || o == nullptr)
+    	{
+    		bh = bt;
+    		return t;
+    	}
+    	node_base *l, *m, *r, *pred;
+    	size_t bl, br;
+    	split(t, bt, keyOf(o), l, bl, m, r, br, pred);
+    	l = subtract(l, bl, o->ch[0], bl);
+    	r = subtract(r, br, o->ch[1], br);
+    	if (m != nullptr)
+    	{
+    		m->adj[0]->adj[1] = m->adj[1];
+    		m->adj[1]->adj[0] = m->adj[0];
+    		--dataSize;
+    		dispose(static_cast<node*>(m));
+    	}
+    	return concat(l, bl, r, br, bh);
+    }
+    //a map sharing the pool of the map it is split from
+    map(const Compare &comp, pool *shared) : cc(comp), memory(shared)
+    {
+    	++memory->refs;
+    	init();
     }
 public:
 	/**
@@ -208,8 +952,8 @@ public:
 		friend map;
 	private:
 		map *mp;
-		node *nd;
-		iterator(map *_mp, node *_nd) : mp(_mp), nd(_nd) {}
+		node_base *nd;
+		iterator(map *_mp, node_base *_nd) : mp(_mp), nd(_nd) {}
 	public:
 		iterator() : mp(nullptr), nd(nullptr) {}
 		iterator(const iterator &other) : mp(other.mp), nd(other.nd) {}
@@ -223,8 +967,6 @@ public:
 		 */
 		iterator operator++(int)
 		{
-			if (*this == mp->end())
-				throw invalid_iterator();
 			iterator ret(*this);
 			nd = mp->succ(nd);
 			return ret;
@@ -234,8 +976,6 @@ public:
 		 */
 		iterator & operator++()
 		{
-			if (*this == mp->end())
-				throw invalid_iterator();
 			nd = mp->succ(nd);
 			return *this;
 		}
@@ -244,17 +984,8 @@ public:
 		 */
 		iterator operator--(int)
 		{
-			if (*this == mp->begin())
-				throw invalid_iterator();
 			iterator ret(*this);
-			if (*this == mp->end())
-			{
-				nd = mp->root;
-				while (nd->ch[1] != nullptr)
-					nd = nd->ch[1];
-			}
-			else
-				nd = mp->prev(nd);
+			nd = mp->prev(nd);
 			return ret;
 		}
 		/**
@@ -262,24 +993,31 @@ public:
 		 */
 		iterator & operator--()
 		{
-			if (*this == mp->begin())
-				throw invalid_iterator();
-			if (*this == mp->end())
-			{
-				nd = mp->root;
-				while (nd->ch[1] != nullptr)
-					nd = nd->ch[1];
-			}
-			else
-				nd = mp->prev(nd);
+			nd = mp->prev(nd);
 			return *this;
 		}
+		/**
+		 * return the distance between two iterators in O(log n),
+		 *   throw invalid_iterator if they belong to different maps.
+		 */
+		std::ptrdiff_t operator-(const iterator &rhs) const
+		{
+			if (mp != rhs.mp)
+				throw invalid_iterator();
+			return std::ptrdiff_t(mp->order(nd)) - std::ptrdiff_t(mp->order(rhs.nd));
+		}
+		std::ptrdiff_t operator-(const const_iterator &rhs) const
+		{
+			if (mp != rhs.mp)
+				throw invalid_iterator();
+			return std::ptrdiff_t(mp->order(nd)) - std::ptrdiff_t(mp->order(rhs.nd));
+		}
 		/**
 		 * a operator to check whether two iterators are same (pointing to the same memory).
 		 */
 		value_type & operator*() const
 		{
-			return nd->value;
+			return static_cast<node*>(nd)->value;
 		}
 		bool operator==(const iterator &rhs) const
 		{
@@ -307,7 +1045,7 @@ public:
 		 */
 		value_type* operator->() const noexcept
 		{
-			return &(nd->value);
+			return &(static_cast<node*>(nd)->value);
 		}
 	};
 	class const_iterator
@@ -317,16 +1055,14 @@ public:
 		//  and it should be able to construct from an iterator.
 	private:
 		const map *mp;
-		node *nd;
-		const_iterator(const map *_mp, node *_nd) : mp(_mp), nd(_nd) {}
+		node_base *nd;
+		const_iterator(const map *_mp, node_base *_nd) : mp(_mp), nd(_nd) {}
 	public:
 		const_iterator() : mp(nullptr), nd(nullptr) {}
 		const_iterator(const const_iterator &other) : mp(other.mp), nd(other.nd) {}
 		const_iterator(const iterator &other) : mp(other.mp), nd(other.nd) {}
 		const_iterator operator++(int)
 		{
-			if (*this == mp->cend())
-				throw invalid_iterator();
 			const_iterator ret(*this);
 			nd = mp->succ(nd);
 			return ret;
@@ -336,8 +1072,6 @@ public:
 		 */
 		const_iterator & operator++()
 		{
-			if (*this == mp->cend())
-				throw invalid_iterator();
 			nd = mp->succ(nd);
 			return *this;
 		}
@@ -346,17 +1080,8 @@ public:
 		 */
 		const_iterator operator--(int)
 		{
-			if (*this == mp->cbegin())
-				throw invalid_iterator();
 			const_iterator ret(*this);
-			if (*this == mp->cend())
-			{
-				nd = mp->root;
-				while (nd->ch[1] != nullptr)
-					nd = nd->ch[1];
-			}
-			else
-				nd = mp->prev(nd);
+			nd = mp->prev(nd);
 			return ret;
 		}
 		/**
@@ -364,24 +1089,31 @@ public:
 		 */
 		const_iterator & operator--()
 		{
-			if (*this == mp->cbegin())
-				throw invalid_iterator();
-			if (*this == mp->cend())
-			{
-				nd = mp->root;
-				while (nd->ch[1] != nullptr)
-					nd = nd->ch[1];
-			}
-			else
-				nd = mp->prev(nd);
+			nd = mp->prev(nd);
 			return *this;
 		}
+		/**
+		 * return the distance between two iterators in O(log n),
+		 *   throw invalid_iterator if they belong to different maps.
+		 */
+		std::ptrdiff_t operator-(const iterator &rhs) const
+		{
+			if (mp != rhs.mp)
+				throw invalid_iterator();
+			return std::ptrdiff_t(mp->order(nd)) - std::ptrdiff_t(mp->order(rhs.nd));
+		}
+		std::ptrdiff_t operator-(const const_iterator &rhs) const
+		{
+			if (mp != rhs.mp)
+				throw invalid_iterator();
+			return std::ptrdiff_t(mp->order(nd)) - std::ptrdiff_t(mp->order(rhs.nd));
+		}
 		/**
 		 * a operator to check whether two iterators are same (pointing to the same memory).
 		 */
 		const value_type & operator*() const
 		{
-			return nd->value;
+			return static_cast<node*>(nd)->value;
 		}
 		bool operator==(const iterator &rhs) const
 		{
@@ -409,20 +1141,58 @@ public:
 		 */
 		const value_type* operator->() const noexcept
 		{
-			return &(nd->value);
+			return &(static_cast<node*>(nd)->value);
 		}
 	};
 
-	map()
+	map() : memory(newPool(node_allocator()))
 	{
-		root = nullptr;
-		dataSize = 0;
+		init();
+	}
+	explicit map(const Compare &comp, const Allocator &_alloc = Allocator()) : cc(comp), memory(newPool(node_allocator(_alloc)))
+	{
+		init();
 	}
-	map(const map &other)
+	/**
+	 * construct from the elements of [first, last), see assign_sorted.
+	 */
+	template<class InputIterator>
+	map(InputIterator first, InputIterator last, const Compare &comp = Compare(), const Allocator &_alloc = Allocator())
+		: cc(comp), memory(newPool(node_allocator(_alloc)))
 	{
-		root = nullptr;
-		cra(&root, other.root);
-		dataSize = other.dataSize;
+		init();
+		try
+		{
+			assign_sorted(first, last);
+		}
+		catch (...)
+		{
+			del();
+			leave();
+			throw;
+		}
+	}
+	map(const map &other) : cc(other.cc), memory(newPool(other.memory->alloc))
+	{
+		try
+		{
+			copy(other);
+		}
+		catch (...)
+		{
+			leave();
+			throw;
+		}
+	}
+	/**
+	 * take the elements of other in O(1), other is left empty.
+	 * the node pool is taken too, and other gets a new one.
+	 */
+	map(map &&other) : cc(other.cc), memory(other.memory)
+	{
+		init();
+		other.memory = newPool(memory->alloc);
+		take(other);
 	}
 	/**
 	 * TODO assignment operator
@@ -431,17 +1201,17 @@ public:
 	{
 		if (this == &other)
 			return *this;
-		del(root);
-		root = nullptr;
-		cra(&root, other.root);
-		dataSize = other.dataSize;
+		del();
+		copy(other);
+		return *this;
 	}
 	/**
 	 * TODO Destructors
 	 */
 	~map()
 	{
-		del(root);
+		del();
+		leave();
 	}
 	/**
 	 * TODO
@@ -451,25 +1221,17 @@ public:
 	 */
 	T & at(const Key &key)
 	{
-		node *cur = root;
-		while (cur != nullptr)
-		{
-			if (equal(cur->value.first, key))
-				return cur->value.second;
-			cur = cur->ch[cc(cur->value.first, key)];
-		}
-		throw index_out_of_bound();
+		node_base *cur = search(key);
+		if (cur == nullptr)
+			throw index_out_of_bound();
+		return valueOf(cur).second;
 	}
 	const T & at(const Key &key) const
 	{
-		node *cur = root;
-		while (cur != nullptr)
-		{
-			if (equal(cur->value.first, key))
-				return cur->value.second;
-			cur = cur->ch[cc(cur->value.first, key)];
-		}
-		throw index_out_of_bound();
+		node_base *cur = search(key);
+		if (cur == nullptr)
+			throw index_out_of_bound();
+		return valueOf(cur).second;
 	}
 	/**
 	 * TODO
@@ -479,21 +1241,10 @@ public:
 	 */
 	T & operator[](const Key &key)
 	{
-		node **cur = &root, *tmp = nullptr;
-		while (*cur != nullptr)
-		{
-			if (equal((*cur)->value.first, key))
-				return (*cur)->value.second;
-			tmp = *cur;
-			cur = &((*cur)->ch[cc((*cur)->value.first, key)]);
-		}
-		*cur = new node(key);
-		(*cur)->par = tmp;
-		(*cur)->color = 1;
-		++dataSize;
-		node *ret = *cur;
-		fixInsert(*cur);
-		return ret->value.second;
+		node_base *p, **cur = locate(key, p);
+		if (*cur != nullptr)
+			return valueOf(*cur).second;
+		return valueOf(link(cur, p, create(key))).second;
 	}
 	/**
 	 * behave like at() throw index_out_of_bound if such key does not exist.
@@ -507,17 +1258,11 @@ public:
 	 */
 	iterator begin()
 	{
-		node *cur = root;
-		while (cur != nullptr && cur->ch[0] != nullptr)
-			cur = cur->ch[0];
-		return iterator(this, cur);
+		return iterator(this, head.adj[1]);
 	}
 	const_iterator cbegin() const
 	{
-		node *cur = root;
-		while (cur != nullptr && cur->ch[0] != nullptr)
-			cur = cur->ch[0];
-		return const_iterator(this, cur);
+		return const_iterator(this, head.adj[1]);
 	}
 	/**
 	 * return a iterator to the end
@@ -525,11 +1270,11 @@ public:
 	 */
 	iterator end()
 	{
-		return iterator(this, nullptr);
+		return iterator(this, &head);
 	}
 	const_iterator cend() const
 	{
-		return const_iterator(this, nullptr);
+		return const_iterator(this, header());
 	}
 	/**
 	 * checks whether the container is empty
@@ -547,13 +1292,22 @@ public:
 		return dataSize;
 	}
 	/**
-	 * clears the contents
+	 * returns the allocator of the elements.
+	 */
+	Allocator get_allocator() const
+	{
+		return Allocator(memory->alloc);
+	}
+	/**
+	 * clears the contents and returns the node chunks to the allocator,
+	 *   unless the pool is shared with another map.
 	 */
 	void clear()
 	{
-		del(root);
-		root = nullptr;
-		dataSize = 0;
+		del();
+		if (memory->refs == 1)
+			memory->release();
+		init();
 	}
 	/**
 	 * insert an element.
@@ -563,21 +1317,167 @@ public:
 	 */
 	pair<iterator, bool> insert(const value_type &value)
 	{
-		node **cur = &root, *tmp = nullptr;
-		while (*cur != nullptr)
+		node_base *p, **cur = locate(value.first, p);
+		if (*cur != nullptr)
+			return pair<iterator, bool>(iterator(this, *cur), 0);
+		return pair<iterator, bool>(iterator(this, link(cur, p, create(value))), 1);
+	}
+	pair<iterator, bool> insert(value_type &&value)
+	{
+		node_base *p, **cur = locate(value.first, p);
+		if (*cur != nullptr)
+			return pair<iterator, bool>(iterator(this, *cur), 0);
+		return pair<iterator, bool>(iterator(this, link(cur, p, create(std::move(value)))), 1);
+	}
+	/**
+	 * insert value as close as possible to the position just before hint.
+	 * if the key of value belongs right there, the tree is not searched,
+	 *   so inserting sorted keys with hint end() costs amortized O(1) rotations
+	 *   (the subtree sizes on the path to the root are still updated).
+	 * return an iterator to the new element or the one that prevented the insertion.
+	 */
+	iterator insert(iterator hint, const value_type &value)
+	{
+		if (hint.mp != this)
+			throw invalid_iterator();
+		node_base *p, **cur = locate(hint.nd, value.first, p);
+		if (*cur != nullptr)
+			return iterator(this, *cur);
+		return iterator(this, link(cur, p, create(value)));
+	}
+	iterator insert(iterator hint, value_type &&value)
+	{
+		if (hint.mp != this)
+			throw invalid_iterator();
+		node_base *p, **cur = locate(hint.nd, value.first, p);
+		if (*cur != nullptr)
+			return iterator(this, *cur);
+		return iterator(this, link(cur, p, create(std::move(value))));
+	}
+	/**
+	 * replace the contents with the elements of [first, last).
+	 * while the keys are strictly increasing, the new nodes are only appended to
+	 *   the list, and a balanced tree is built from it in O(n) without any rotation;
+	 *   the rest of the range, if any, is inserted one by one.
+	 */
+	template<class InputIterator>
+	void assign_sorted(InputIterator first, InputIterator last)
+	{
+		clear();
+		node *x = nullptr;
+		try
+		{
+			for (; first != last; ++first)
+			{
+				x = create(*first);
+				if (dataSize != 0 && !cc(keyOf(head.adj[0]), x->value.first))
+					break;
+				thread(x, &head, 0);
+				++dataSize;
+				x = nullptr;
+			}
+		}
+		catch (...)
 		{
-			if (equal((*cur)->value.first, value.first))
-				return pair<iterator, bool>(iterator(this, *cur), 0);
-			tmp = *cur;
-			cur = &((*cur)->ch[cc((*cur)->value.first, value.first)]);
+			//x is not in the list yet if cc threw
+			if (x != nullptr)
+				dispose(x);
+			rebuild();
+			throw;
 		}
-		*cur = new node(value);
-		++dataSize;
-		(*cur)->par = tmp;
-		(*cur)->color = 1;
-		node *ret = *cur;
-		fixInsert(*cur);
-		return pair<iterator, bool>(iterator(this, ret), 1);
+		rebuild();
+		if (x == nullptr)
+			return;
+		node_base *p, **cur;
+		try
+		{
+			cur = locate(x->value.first, p);
+		}
+		catch (...)
+		{
+			dispose(x);
+			throw;
+		}
+		if (*cur != nullptr)
+			dispose(x);
+		else
+			link(cur, p, x);
+		for (++first; first != last; ++first)
+			emplace(*first);
+	}
+	/**
+	 * construct the value (key, mapped value) in the new node directly from args,
+	 *   the node is released if the key already exists.
+	 * return the same as insert.
+	 */
+	template<class... Args>
+	pair<iterator, bool> emplace(Args&&... args)
+	{
+		node *x = create(std::forward<Args>(args)...);
+		node_base *p, **cur;
+		try
+		{
+			cur = locate(x->value.first, p);
+		}
+		catch (...)
+		{
+			dispose(x);
+			throw;
+		}
+		if (*cur != nullptr)
+		{
+			dispose(x);
+			return pair<iterator, bool>(iterator(this, *cur), 0);
+		}
+		return pair<iterator, bool>(iterator(this, link(cur, p, x)), 1);
+	}
+	/**
+	 * if key does not exist, insert (key, T(args...)), otherwise do nothing
+	 *   (args are not touched).
+	 * return the same as insert.
+	 */
+	template<class... Args>
+	pair<iterator, bool> try_emplace(const Key &key, Args&&... args)
+	{
+		node_base *p, **cur = locate(key, p);
+		if (*cur != nullptr)
+			return pair<iterator, bool>(iterator(this, *cur), 0);
+		return pair<iterator, bool>(iterator(this, link(cur, p, create(key, T(std::forward<Args>(args)...)))), 1);
+	}
+	template<class... Args>
+	pair<iterator, bool> try_emplace(Key &&key, Args&&... args)
+	{
+		node_base *p, **cur = locate(key, p);
+		if (*cur != nullptr)
+			return pair<iterator, bool>(iterator(this, *cur), 0);
+		return pair<iterator, bool>(iterator(this, link(cur, p, create(std::move(key), T(std::forward<Args>(args)...)))), 1);
+	}
+	/**
+	 * if key exists, assign obj to its mapped value, otherwise insert (key, obj).
+	 * the tree is descended once, and no T is default-constructed as with map[key] = obj.
+	 * return the same as insert, the second is false if obj was assigned.
+	 */
+	template<class M>
+	pair<iterator, bool> insert_or_assign(const Key &key, M &&obj)
+	{
+		node_base *p, **cur = locate(key, p);
+		if (*cur != nullptr)
+		{
+			valueOf(*cur).second = std::forward<M>(obj);
+			return pair<iterator, bool>(iterator(this, *cur), 0);
+		}
+		return pair<iterator, bool>(iterator(this, link(cur, p, create(key, std::forward<M>(obj)))), 1);
+	}
+	template<class M>
+	pair<iterator, bool> insert_or_assign(Key &&key, M &&obj)
+	{
+		node_base *p, **cur = locate(key, p);
+		if (*cur != nullptr)
+		{
+			valueOf(*cur).second = std::forward<M>(obj);
+			return pair<iterator, bool>(iterator(this, *cur), 0);
+		}
+		return pair<iterator, bool>(iterator(this, link(cur, p, create(std::move(key), std::forward<M>(obj)))), 1);
 	}
 	/**
 	 * erase the element at pos.
@@ -586,21 +1486,22 @@ public:
 	 */
 	void erase(iterator pos)
 	{
-		if (pos.mp != this || pos == end())
+		if (pos.mp != this || pos.nd == &head)
 			throw invalid_iterator();
 		--dataSize;
-		node *z = pos.nd, *y, *x, *xp;
+		node_base *z = pos.nd, *y, *x, *xp;
 		bool color;
+		z->adj[0]->adj[1] = z->adj[1];
+		z->adj[1]->adj[0] = z->adj[0];
 		if (z->ch[0] != nullptr && z->ch[1] != nullptr)
 		{
 			y = z->ch[1];
 			while (y->ch[0] != nullptr)
 				y = y->ch[0];
+			for (node_base *q = y->par; q != &head; q = q->par)
+				--q->size;
 			
-			if (z == root)
-				root = y;
-			else
-				z->par->ch[chlr(z)] = y;
+			z->par->ch[chlr(z)] = y;
 				
 			x = y->ch[1];
 			xp = y->par;
@@ -621,12 +1522,13 @@ public:
 			}
 			y->par = z->par;
 			y->color = z->color;
+			y->size = z->size;
 			y->ch[0] = z->ch[0];
 			z->ch[0]->par = y;
 			
 			if (color == 0)
 				fixDelete(x, xp);
-			delete z;
+			dispose(static_cast<node*>(z));
 			return;
 		}
 		
@@ -638,14 +1540,13 @@ public:
 		color = z->color;
 		if (x != nullptr)
 			x->par = xp;
+		for (node_base *q = xp; q != &head; q = q->par)
+			--q->size;
 			
-		if (z == root)
-			root = x;
-		else
-			xp->ch[chlr(z)] = x;
+		xp->ch[chlr(z)] = x;
 		if (color == 0)
 			fixDelete(x, xp);
-		delete z;
+		dispose(static_cast<node*>(z));
 	}
 	/**
 	 * Returns the number of elements with key 
@@ -656,14 +1557,7 @@ public:
 	 */
 	size_t count(const Key &key) const
 	{
-		node *cur = root;
-		while (cur != nullptr)
-		{
-			if (equal(cur->value.first, key))
-				return 1;
-			cur = cur->ch[cc(cur->value.first, key)];
-		}
-		return 0;
+		return search(key) != nullptr;
 	}
 	/**
 	 * Finds an element with key equivalent to key.
@@ -673,25 +1567,282 @@ public:
 	 */
 	iterator find(const Key &key)
 	{
-		node *cur = root;
+		node_base *cur = search(key);
+		return cur == nullptr ? end() : iterator(this, cur);
+	}
+	const_iterator find(const Key &key) const
+	{
+		node_base *cur = search(key);
+		return cur == nullptr ? cend() : const_iterator(this, cur);
+	}
+	/**
+	 * return an iterator to the k-th smallest element (counting from 0) in O(log n),
+	 *   throw index_out_of_bound if k >= size().
+	 */
+	iterator nth(size_t k)
+	{
+		return iterator(this, select(k));
+	}
+	const_iterator nth(size_t k) const
+	{
+		return const_iterator(this, select(k));
+	}
+	/**
+	 * return the number of elements whose key is less than key, in O(log n).
+	 */
+	size_t rank(const Key &key) const
+	{
+		node_base *cur = head.ch[0];
+		size_t ret = 0;
 		while (cur != nullptr)
 		{
-			if (equal(cur->value.first, key))
-				return iterator(this, cur);
-			cur = cur->ch[cc(cur->value.first, key)];
+			if (cc(keyOf(cur), key))
+			{
+				ret += sizeOf(cur->ch[0]) + 1;
+				cur = cur->ch[1];
+			}
+			else
+				cur = cur->ch[0];
 		}
-		return end();
+		return ret;
 	}
-	const_iterator find(const Key &key) const
+	/**
+	 * return an iterator to the first element whose key is not less than key,
+	 *   or end() if there is no such element.
+	 */
+	iterator lower_bound(const Key &key)
 	{
-		node *cur = root;
-		while (cur != nullptr)
+		return iterator(this, bound(key, 0));
+	}
+	const_iterator lower_bound(const Key &key) const
+	{
+		return const_iterator(this, bound(key, 0));
+	}
+	/**
+	 * return an iterator to the first element whose key is greater than key,
+	 *   or end() if there is no such element.
+	 */
+	iterator upper_bound(const Key &key)
+	{
+		return iterator(this, bound(key, 1));
+	}
+	const_iterator upper_bound(const Key &key) const
+	{
+		return const_iterator(this, bound(key, 1));
+	}
+	/**
+	 * return the range [lower_bound(key), upper_bound(key)),
+	 *   which holds at most one element since keys are unique.
+	 * only one descent is made.
+	 */
+	pair<iterator, iterator> equal_range(const Key &key)
+	{
+		node_base *lo = bound(key, 0);
+		return pair<iterator, iterator>(iterator(this, lo), iterator(this, rangeEnd(lo, key)));
+	}
+	pair<const_iterator, const_iterator> equal_range(const Key &key) const
+	{
+		node_base *lo = bound(key, 0);
+		return pair<const_iterator, const_iterator>(const_iterator(this, lo), const_iterator(this, rangeEnd(lo, key)));
+	}
+	/**
+	 * heterogeneous lookup: if Compare has a member type is_transparent,
+	 *   the following take any K that Compare can compare with Key,
+	 *   e.g. a const char * for a std::string key with std::less<>,
+	 *   and no Key is constructed.
+	 */
+	template<class K, class C = Compare, class = typename C::is_transparent>
+	T & at(const K &key)
+	{
+		node_base *cur = search(key);
+		if (cur == nullptr)
+			throw index_out_of_bound();
+		return valueOf(cur).second;
+	}
+	template<class K, class C = Compare, class = typename C::is_transparent>
+	const T & at(const K &key) const
+	{
+		node_base *cur = search(key);
+		if (cur == nullptr)
+			throw index_out_of_bound();
+		return valueOf(cur).second;
+	}
+	template<class K, class C = Compare, class = typename C::is_transparent>
+	size_t count(const K &key) const
+	{
+		return search(key) != nullptr;
+	}
+	template<class K, class C = Compare, class = typename C::is_transparent>
+	iterator find(const K &key)
+	{
+		node_base *cur = search(key);
+		return cur == nullptr ? end() : iterator(this, cur);
+	}
+	template<class K, class C = Compare, class = typename C::is_transparent>
+	const_iterator find(const K &key) const
+	{
+		node_base *cur = search(key);
+		return cur == nullptr ? cend() : const_iterator(this, cur);
+	}
+	template<class K, class C = Compare, class = typename C::is_transparent>
+	iterator lower_bound(const K &key)
+	{
+		return iterator(this, bound(key, 0));
+	}
+	template<class K, class C = Compare, class = typename C::is_transparent>
+	const_iterator lower_bound(const K &key) const
+	{
+		return const_iterator(this, bound(key, 0));
+	}
+	template<class K, class C = Compare, class = typename C::is_transparent>
+	iterator upper_bound(const K &key)
+	{
+		return iterator(this, bound(key, 1));
+	}
+	template<class K, class C = Compare, class = typename C::is_transparent>
+	const_iterator upper_bound(const K &key) const
+	{
+		return const_iterator(this, bound(key, 1));
+	}
+	template<class K, class C = Compare, class = typename C::is_transparent>
+	pair<iterator, iterator> equal_range(const K &key)
+	{
+		node_base *lo = bound(key, 0);
+		return pair<iterator, iterator>(iterator(this, lo), iterator(this, rangeEnd(lo, key)));
+	}
+	template<class K, class C = Compare, class = typename C::is_transparent>
+	pair<const_iterator, const_iterator> equal_range(const K &key) const
+	{
+		node_base *lo = bound(key, 0);
+		return pair<const_iterator, const_iterator>(const_iterator(this, lo), const_iterator(this, rangeEnd(lo, key)));
+	}
+	/**
+	 * call f(value) on every element whose key is in [lo, hi), in key order.
+	 * the tree is descended once to find lo, then the elements are visited
+	 *   through the list links until a key not less than hi is met.
+	 * f must not insert into or erase from this map.
+	 */
+	template<class F>
+	void for_each_in(const Key &lo, const Key &hi, F f)
+	{
+		for (node_base *cur = bound(lo, 0); cur != &head && cc(keyOf(cur), hi); cur = cur->adj[1])
+			f(valueOf(cur));
+	}
+	template<class F>
+	void for_each_in(const Key &lo, const Key &hi, F f) const
+	{
+		for (node_base *cur = bound(lo, 0); cur != &head && cc(keyOf(cur), hi); cur = cur->adj[1])
+			f(static_cast<const value_type &>(valueOf(cur)));
+	}
+	/**
+	 * move the elements whose keys are not less than key into a new map and return it.
+	 * the tree is cut with the red-black split in O(log n) and the list at lower_bound(key);
+	 *   no node is copied, the two maps share the node pool.
+	 * the shared pool is not synchronized, so the two maps (and maps split from them)
+	 *   must not be modified from different threads at the same time.
+	 * iterators to the moved elements are invalidated.
+	 */
+	map split_at(const Key &key)
+	{
+		map ret(cc, memory);
+		node_base *first = bound(key, 0);
+		if (first == &head)
+			return ret;
+		node_base *l, *m, *r, *pred;
+		size_t bt, bl, br;
+		try
+		{
+			node_base *t = detach(bt);
+			split(t, bt, key, l, bl, m, r, br, pred);
+		}
+		catch (...)
+		{
+			rebuild();
+			throw;
+		}
+		if (m != nullptr)
+			r = join(nullptr, 0, m, r, br, br);
+		node_base *last = first->adj[0];
+		ret.head.adj[1] = first;
+		ret.head.adj[0] = head.adj[0];
+		first->adj[0] = ret.head.adj[0]->adj[1] = &ret.head;
+		head.adj[0] = last;
+		last->adj[1] = &head;
+		ret.dataSize = sizeOf(r);
+		dataSize = sizeOf(l);
+		ret.attach(r);
+		attach(l);
+		return ret;
+	}
+	/**
+	 * the set operations below change this map by the keys of other.
+	 * with m = other.size() and n = size(), each costs O(m log(n / m + 1)) comparisons:
+	 *   the tree of this is split at the root key of other, and the halves are processed
+	 *   with its subtrees and joined back, instead of m separate descents.
+	 * other is not changed, nothing is allocated but the copies of merge_union.
+	 * if a copy or Compare throws, the elements handled so far stay and the tree is
+	 *   rebuilt from the list in O(n).
+	 */
+	/**
+	 * insert a copy of every element of other whose key is not in this,
+	 *   the elements of this are kept for the keys in both.
+	 */
+	void merge_union(const map &other)
+	{
+		if (&other == this)
+			return;
+		size_t bt;
+		try
+		{
+			node_base *t = detach(bt);
+			attach(unite(t, bt, other.head.ch[0], &head, bt));
+		}
+		catch (...)
+		{
+			rebuild();
+			throw;
+		}
+	}
+	/**
+	 * erase the elements whose keys are not in other.
+	 */
+	void intersect(const map &other)
+	{
+		if (&other == this)
+			return;
+		size_t bt;
+		try
+		{
+			node_base *t = detach(bt);
+			attach(meet(t, bt, other.head.ch[0], bt));
+		}
+		catch (...)
+		{
+			rebuild();
+			throw;
+		}
+	}
+	/**
+	 * erase the elements whose keys are in other.
+	 */
+	void difference(const map &other)
+	{
+		if (&other == this)
+		{
+			clear();
+			return;
+		}
+		size_t bt;
+		try
+		{
+			node_base *t = detach(bt);
+			attach(subtract(t, bt, other.head.ch[0], bt));
+		}
+		catch (...)
 		{
-			if (equal(cur->value.first, key))
-				return const_iterator(this, cur);
-			cur = cur->ch[cc(cur->value.first, key)];
+			rebuild();
+			throw;
 		}
-		return cend();
 	}
 };
 
@@ -3,6 +3,9 @@
 
 #include <cstddef>
 #include <functional>
+#include <memory>
+#include <new>
+#include <utility>
 #include "exceptions.hpp"
 
 namespace sjtu {
@@ -10,8 +13,9 @@ namespace sjtu {
 /**
  * a container like std::priority_queue which is a heap internal.
  * it should be based on the vector written by yourself.
+ * the nodes are obtained from Allocator (rebound to the node type).
  */
-template<typename T, class Compare = std::less<T>>
+template<typename T, class Compare = std::less<T>, class Allocator = std::allocator<T>>
 class priority_queue {
 private:
 	class node
@@ -21,7 +25,9 @@ private:
 			size_t degree;
 			node *left, *right, *child;
 
-            node(const T &_key, const size_t &_degree = 0) : degree(_degree), key(_key), left(this), right(this), child(nullptr) {}
+            //key is constructed from args
+            template<class... Args>
+            node(const size_t &_degree, Args&&... args) : key(std::forward<Args>(args)...), degree(_degree), left(this), right(this), child(nullptr) {}
             ~node() {}
 	};
 
@@ -29,6 +35,44 @@ private:
     node *min;
     node **A;
     Compare cc;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<node> node_allocator;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<node*> array_allocator;
+    node_allocator nodeAlloc;
+    array_allocator arrayAlloc;
+
+    //allocate a node and construct it from args
+    template<class... Args>
+    node *create(Args&&... args)
+    {
+        node *ret = std::allocator_traits<node_allocator>::allocate(nodeAlloc, 1);
+        new(ret) node(std::forward<Args>(args)...);
+        return ret;
+    }
+    void dispose(node *x)
+    {
+        x->~node();
+        std::allocator_traits<node_allocator>::deallocate(nodeAlloc, x, 1);
+    }
+    //add a single node to the root list
+    void link(node *nd)
+    {
+        if (empty())
+            min = nd;
+        else
+        {
+            addToList(nd, min);
+            if (cc(min->key, nd->key))
+                min = nd;
+        }
+        ++keyNum;
+    }
+    //the array used by consolidate
+    void initArray()
+    {
+        A = std::allocator_traits<array_allocator>::allocate(arrayAlloc, 64);
+        for (int i = 0; i < 64; i++)
+        	A[i] = nullptr;
+    }
     
     void del(node *cur)
     {
@@ -39,7 +83,7 @@ private:
         {
        		del(tmp->child);
         	_right = tmp->right;
-            delete tmp;
+            dispose(tmp);
             tmp = _right;
         } while(tmp != cur);
     }
@@ -47,13 +91,13 @@ private:
     {
     	if (other == nullptr)
     		return;
-        node *tail = new node(other->key, other->degree);
+        node *tail = create(other->degree, other->key);
         node *head = tail;
         cra(&(tail->child), other->child);
         node *tmp = other->right;
         while (tmp != other)
         {
-            tail->right = new node(tmp->key, tmp->degree);
+            tail->right = create(tmp->degree, tmp->key);
             tail->right->left = tail;
             tail = tail->right;
 
@@ -73,18 +117,20 @@ public:
     {
         keyNum = 0;
         min = nullptr;
-        A = new node*[64];
-        for (int i = 0; i < 64; i++)
-        	A[i] = nullptr;
+        initArray();
+    }
+	explicit priority_queue(const Compare &comp, const Allocator &_alloc = Allocator()) : cc(comp), nodeAlloc(_alloc), arrayAlloc(_alloc)
+    {
+        keyNum = 0;
+        min = nullptr;
+        initArray();
     }
-	priority_queue(const priority_queue &other)
+	priority_queue(const priority_queue &other) : cc(other.cc), nodeAlloc(other.nodeAlloc), arrayAlloc(other.arrayAlloc)
     {
     	min = nullptr;
     	cra(&min, other.min);
         keyNum = other.keyNum;
-        A = new node*[64];
-        for (int i = 0; i < 64; i++)
-        	A[i] = nullptr;
+        initArray();
     }
 	/**
 	 * TODO deconstructor
@@ -92,7 +138,7 @@ public:
 	~priority_queue()
     {
        	del(min);
-        delete []A;
+        std::allocator_traits<array_allocator>::deallocate(arrayAlloc, A, 64);
     }
 	/**
 	 * TODO Assignment operator
@@ -129,16 +175,19 @@ public:
     }
 	void push(const T &e)
     {
-        node *nd = new node(e);
-        if (empty())
-            min = nd;
-        else
-        {
-            addToList(nd, min);
-            if (cc(min->key, e))
-                min = nd;
-        }
-        ++keyNum;
+        link(create(0, e));
+    }
+	void push(T &&e)
+    {
+        link(create(0, std::move(e)));
+    }
+	/**
+	 * construct the new element in place, args are forwarded to the constructor of T.
+	 */
+	template<class... Args>
+	void emplace(Args&&... args)
+    {
+        link(create(0, std::forward<Args>(args)...));
     }
 	/**
 	 * TODO
@@ -207,7 +256,7 @@ public:
         --keyNum;
         if (empty())
         {
-            delete min;
+            dispose(min);
             min = nullptr;
         }
         else
@@ -215,7 +264,7 @@ public:
             min->left->right = min->right;
             min->right->left = min->left;
             tmp = min->right;
-            delete min;
+            dispose(min);
             min = tmp;
             consolidate();
         }
@@ -235,8 +284,16 @@ public:
     {
         return keyNum == 0;
     }
+	/**
+	 * returns the allocator of the elements.
+	 */
+	Allocator get_allocator() const
+	{
+		return Allocator(nodeAlloc);
+	}
 	/**
 	 * return a merged priority_queue with at least O(logn) complexity.
+	 * the nodes of other are taken over, so the two allocators should be equal.
 	 */
 	void merge(priority_queue &other)
     {
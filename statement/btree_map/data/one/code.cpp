@@ -0,0 +1,125 @@
+#include "btree_map.hpp"
+#include <iostream>
+#include <map>
+#include <string>
+
+//btree_map against std::map: random inserts and erases, lookups, bounds, iteration and copies
+
+unsigned long long seed = 20200303;
+
+unsigned rnd()
+{
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return seed >> 33;
+}
+
+void error()
+{
+	std::cout << "Error, mismatch found." << std::endl;
+	exit(0);
+}
+
+class Integer {
+public:
+	int val;
+	Integer(int val) : val(val) {}
+	Integer(const Integer &rhs) : val(rhs.val) {}
+};
+
+class Compare {
+public:
+	bool operator () (const Integer &lhs, const Integer &rhs) const {
+		return lhs.val < rhs.val;
+	}
+};
+
+typedef sjtu::btree_map<Integer, std::string, Compare> bmap;
+
+void check(const bmap &m, const std::map<int, std::string> &s)
+{
+	if (m.size() != s.size() || m.empty() != s.empty())
+		error();
+	auto it = m.cbegin();
+	for (auto jt = s.begin(); jt != s.end(); ++jt, ++it)
+		if (it == m.cend() || it->first.val != jt->first || it->second != jt->second)
+			error();
+	if (it != m.cend())
+		error();
+	for (auto jt = s.rbegin(); jt != s.rend(); ++jt)
+		if ((--it)->first.val != jt->first)
+			error();
+}
+
+int main()
+{
+	bmap m;
+	std::map<int, std::string> s;
+	for (int round = 0; round < 10; ++round) {
+		for (int i = 0; i < 30000; ++i) {
+			int key = rnd() % 20000;
+			unsigned op = rnd() % 6;
+			if (op < 2) {
+				m[Integer(key)] = std::to_string(i);
+				s[key] = std::to_string(i);
+			}
+			else if (op < 3) {
+				bool inserted = m.insert(sjtu::pair<Integer, std::string>(Integer(key), std::to_string(i))).second;
+				if (inserted != s.insert(std::make_pair(key, std::to_string(i))).second)
+					error();
+			}
+			else if (op < 5) {
+				auto it = m.find(Integer(key));
+				if ((it == m.end()) != (s.count(key) == 0))
+					error();
+				if (it != m.end()) {
+					m.erase(it);
+					s.erase(key);
+				}
+			}
+			else {
+				if (m.count(Integer(key)) != s.count(key))
+					error();
+				auto lo = m.lower_bound(Integer(key)), hi = m.upper_bound(Integer(key));
+				auto slo = s.lower_bound(key), shi = s.upper_bound(key);
+				if ((lo == m.end()) != (slo == s.end()) || (hi == m.end()) != (shi == s.end()))
+					error();
+				if (lo != m.end() && lo->first.val != slo->first)
+					error();
+				if (hi != m.end() && hi->first.val != shi->first)
+					error();
+				try {
+					const std::string &v = m.at(Integer(key));
+					if (!s.count(key) || v != s[key])
+						error();
+				} catch (sjtu::index_out_of_bound) {
+					if (s.count(key))
+						error();
+				}
+			}
+		}
+		check(m, s);
+		std::cout << s.size() << std::endl;
+	}
+	bmap c(m);
+	check(c, s);
+	c.clear();
+	check(c, std::map<int, std::string>());
+	c = m;
+	m.clear();
+	check(c, s);
+	try {
+		c.erase(c.end());
+		error();
+	} catch (sjtu::invalid_iterator) {}
+	try {
+		c.erase(m.begin());
+		error();
+	} catch (sjtu::invalid_iterator) {}
+	while (!s.empty()) {
+		c.erase(c.begin());
+		s.erase(s.begin());
+	}
+	check(c, s);
+	std::cout << "Passed" << std::endl;
+	return 0;
+}
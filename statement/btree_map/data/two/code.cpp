@@ -0,0 +1,120 @@
+#include "btree_map.hpp"
+#include <iostream>
+#include <map>
+#include <string>
+
+//the members btree_map shares with map: emplace, try_emplace, equal_range, for_each_in,
+//  nth, rank and iterator distance, against std::map
+
+unsigned long long seed = 20240229;
+
+unsigned rnd()
+{
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return seed >> 33;
+}
+
+void error()
+{
+	std::cout << "Error, mismatch found." << std::endl;
+	exit(0);
+}
+
+class Value {
+public:
+	static int built;
+	int val;
+	Value() : val(0) { ++built; }
+	Value(int val) : val(val) { ++built; }
+	Value(const Value &rhs) : val(rhs.val) {}
+};
+
+int Value::built = 0;
+
+typedef sjtu::btree_map<int, Value> bmap;
+
+void check(const bmap &m, const std::map<int, int> &s)
+{
+	if (m.size() != s.size())
+		error();
+	size_t k = 0;
+	for (auto it = s.begin(); it != s.end(); ++it, ++k) {
+		auto jt = m.nth(k);
+		if (jt->first != it->first || jt->second.val != it->second)
+			error();
+		if (m.rank(it->first) != k || m.rank(it->first + 1) != k + 1)
+			error();
+		if (jt - m.cbegin() != (std::ptrdiff_t) k || m.cend() - jt != (std::ptrdiff_t) (s.size() - k))
+			error();
+	}
+	try {
+		m.nth(s.size());
+		error();
+	} catch (sjtu::index_out_of_bound) {}
+}
+
+int main()
+{
+	bmap m;
+	std::map<int, int> s;
+	for (int round = 0; round < 10; ++round) {
+		for (int i = 0; i < 20000; ++i) {
+			int key = rnd() % 30000 * 2;
+			unsigned op = rnd() % 5;
+			if (op == 0) {
+				bool inserted = m.emplace(key, Value(i)).second;
+				if (inserted != s.insert(std::make_pair(key, i)).second)
+					error();
+			}
+			else if (op == 1) {
+				bool inserted = m.try_emplace(key, i).second;
+				if (inserted != s.insert(std::make_pair(key, i)).second)
+					error();
+			}
+			else if (op == 2) {
+				int before = Value::built;
+				bool exists = s.count(key);
+				m[key].val += i;
+				s[key] += i;
+				//T() is only built for a new key
+				if (Value::built - before != !exists)
+					error();
+			}
+			else if (op == 3) {
+				if (s.count(key)) {
+					m.erase(m.find(key));
+					s.erase(key);
+				}
+			}
+			else {
+				auto r = m.equal_range(key);
+				auto sr = s.equal_range(key);
+				if ((r.first == m.end()) != (sr.first == s.end()) || (r.second == m.end()) != (sr.second == s.end()))
+					error();
+				if (r.first != m.end() && r.first->first != sr.first->first)
+					error();
+				if (r.second != m.end() && r.second->first != sr.second->first)
+					error();
+				long long sum = 0, expect = 0;
+				int hi = key + rnd() % 2000;
+				m.for_each_in(key, hi, [&](const sjtu::pair<const int, Value> &v) { sum += v.first ^ v.second.val; });
+				for (auto it = s.lower_bound(key); it != s.end() && it->first < hi; ++it)
+					expect += it->first ^ it->second;
+				if (sum != expect)
+					error();
+			}
+		}
+		check(m, s);
+		std::cout << s.size() << " " << m.nth(s.size() / 2)->first << std::endl;
+	}
+	const bmap c(m);
+	check(c, s);
+	long long sum = 0;
+	c.for_each_in(-1, 1 << 30, [&](const sjtu::pair<const int, Value> &v) { sum += v.second.val; });
+	std::cout << sum << std::endl;
+	m.clear();
+	s.clear();
+	check(m, s);
+	std::cout << "Passed" << std::endl;
+	return 0;
+}
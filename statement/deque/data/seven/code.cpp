@@ -0,0 +1,96 @@
+#include "deque.hpp"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <deque>
+#include <vector>
+
+//push and pop at either end must keep the iterators to the other elements valid
+
+unsigned long long seed = 19260817;
+
+unsigned rnd()
+{
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return seed >> 33;
+}
+
+void error()
+{
+	std::cout << "Error, mismatch found." << std::endl;
+	exit(0);
+}
+
+template<size_t BlockSize>
+void TestSmall()
+{
+	sjtu::deque<int, std::allocator<int>, BlockSize> d;
+	for (int i = 0; i < 9; ++i)
+		d.push_back(i);
+	d.erase(d.begin() + 4);
+	auto it = d.begin() + 6;
+	d.pop_back();
+	std::cout << *it;
+	d.pop_front();
+	d.pop_front();
+	std::cout << " " << *it;
+	d.push_front(-1);
+	d.push_back(100);
+	std::cout << " " << *it << " " << it - d.begin() << std::endl;
+}
+
+template<size_t BlockSize>
+void TestRandom()
+{
+	typedef sjtu::deque<std::string, std::allocator<std::string>, BlockSize> deque;
+	deque d;
+	std::deque<std::string> s;
+	std::deque<typename deque::iterator> its;
+	for (int i = 0; i < 200000; ++i) {
+		unsigned op = rnd() % 10;
+		std::string v = std::to_string(i);
+		if (op < 3 || s.empty()) {
+			d.push_back(v);
+			s.push_back(v);
+			its.push_back(d.end() - 1);
+		}
+		else if (op < 6) {
+			d.push_front(v);
+			s.push_front(v);
+			its.push_front(d.begin());
+		}
+		else if (op < 8) {
+			d.pop_back();
+			s.pop_back();
+			its.pop_back();
+		}
+		else {
+			d.pop_front();
+			s.pop_front();
+			its.pop_front();
+		}
+		if (d.size() != s.size())
+			error();
+		if (!s.empty()) {
+			size_t k = rnd() % s.size();
+			if (*its[k] != s[k] || its[k] - d.begin() != (long long) k)
+				error();
+		}
+	}
+	for (size_t k = 0; k < s.size(); ++k)
+		if (*its[k] != s[k])
+			error();
+	std::cout << d.size() << std::endl;
+}
+
+int main()
+{
+	TestSmall<2>();
+	TestSmall<0>();
+	TestSmall<512>();
+	TestRandom<2>();
+	TestRandom<0>();
+	TestRandom<16>();
+	std::cout << "Passed" << std::endl;
+	return 0;
+}
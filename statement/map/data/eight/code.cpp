@@ -0,0 +1,75 @@
+#include "map.hpp"
+#include <iostream>
+#include <map>
+#include <vector>
+
+//rank, nth and iterator distance against std::map
+
+unsigned long long seed = 998244353;
+
+unsigned rnd()
+{
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return seed >> 33;
+}
+
+void error()
+{
+	std::cout << "Error, mismatch found." << std::endl;
+	exit(0);
+}
+
+void check(const sjtu::map<int, int> &m, const std::map<int, int> &s)
+{
+	if (m.size() != s.size())
+		error();
+	size_t k = 0;
+	for (auto it = s.begin(); it != s.end(); ++it, ++k) {
+		if (m.nth(k)->first != it->first || m.nth(k)->second != it->second)
+			error();
+		if (m.rank(it->first) != k || m.rank(it->first + 1) != k + 1)
+			error();
+		auto jt = m.find(it->first);
+		if (jt - m.cbegin() != (std::ptrdiff_t) k || m.cend() - jt != (std::ptrdiff_t) (s.size() - k))
+			error();
+	}
+	if (m.rank(-1) != 0 || m.rank(1 << 30) != s.size())
+		error();
+	try {
+		m.nth(s.size());
+		error();
+	} catch (sjtu::index_out_of_bound) {}
+}
+
+int main()
+{
+	sjtu::map<int, int> m;
+	std::map<int, int> s;
+	for (int round = 0; round < 10; ++round) {
+		for (int i = 0; i < 20000; ++i) {
+			int key = rnd() % 40000 * 2;
+			if (rnd() % 3 != 0) {
+				m[key] = i;
+				s[key] = i;
+			}
+			else if (s.count(key)) {
+				m.erase(m.find(key));
+				s.erase(key);
+			}
+		}
+		check(m, s);
+		size_t k = rnd() % s.size();
+		auto it = m.nth(k);
+		for (size_t i = 0; i < 100 && it != m.end(); ++i, ++it)
+			if (it - m.begin() != (std::ptrdiff_t) (k + i))
+				error();
+		std::cout << s.size() << " " << m.nth(s.size() / 2)->first << std::endl;
+	}
+	const sjtu::map<int, int> c(m);
+	check(c, s);
+	m.clear();
+	s.clear();
+	check(m, s);
+	std::cout << "Passed" << std::endl;
+	return 0;
+}
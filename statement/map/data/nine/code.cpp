@@ -0,0 +1,124 @@
+#include "map.hpp"
+#include <iostream>
+#include <map>
+#include <vector>
+
+//hinted insert, assign_sorted and the range constructor against std::map
+
+unsigned long long seed = 1000000007;
+
+unsigned rnd()
+{
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return seed >> 33;
+}
+
+void error()
+{
+	std::cout << "Error, mismatch found." << std::endl;
+	exit(0);
+}
+
+typedef sjtu::map<int, int> map;
+typedef sjtu::pair<const int, int> value_type;
+
+void check(const map &m, const std::map<int, int> &s)
+{
+	if (m.size() != s.size())
+		error();
+	auto it = m.cbegin();
+	for (auto jt = s.begin(); jt != s.end(); ++jt, ++it)
+		if (it == m.cend() || it->first != jt->first || it->second != jt->second)
+			error();
+	if (it != m.cend())
+		error();
+	size_t k = 0;
+	for (auto jt = s.begin(); jt != s.end(); ++jt, ++k)
+		if (m.nth(k)->first != jt->first || m.rank(jt->first) != k)
+			error();
+}
+
+void TestHint()
+{
+	map m;
+	std::map<int, int> s;
+	//sorted keys with hint end()
+	for (int i = 0; i < 100000; ++i) {
+		auto it = m.insert(m.end(), value_type(i * 2, i));
+		if (it->first != i * 2)
+			error();
+		s[i * 2] = i;
+	}
+	check(m, s);
+	//reversed keys with hint begin()
+	for (int i = -1; i >= -1000; --i) {
+		m.insert(m.begin(), value_type(i * 2, i));
+		s[i * 2] = i;
+	}
+	check(m, s);
+	//right, wrong and duplicate hints
+	for (int i = 0; i < 100000; ++i) {
+		int key = rnd() % 300000 - 5000;
+		map::iterator hint;
+		switch (rnd() % 3) {
+			case 0: hint = m.lower_bound(key); break;
+			case 1: hint = m.nth(rnd() % m.size()); break;
+			default: hint = m.end();
+		}
+		auto it = m.insert(hint, value_type(key, i));
+		if (it->first != key)
+			error();
+		if (s.insert(std::make_pair(key, i)).second != (it->second == i))
+			error();
+	}
+	check(m, s);
+	try {
+		map other;
+		m.insert(other.end(), value_type(0, 0));
+		error();
+	} catch (sjtu::invalid_iterator) {}
+	std::cout << s.size() << std::endl;
+}
+
+void TestSorted()
+{
+	std::vector<value_type> v;
+	std::map<int, int> s;
+	for (int i = 0; i < 50000; ++i) {
+		v.push_back(value_type(i * 3, i));
+		s[i * 3] = i;
+	}
+	map m(v.begin(), v.end());
+	check(m, s);
+	for (int i = 0; i < 10000; ++i) {
+		int key = rnd() % 150000;
+		if (s.count(key)) {
+			m.erase(m.find(key));
+			s.erase(key);
+		}
+		else {
+			m[key] = -1;
+			s[key] = -1;
+		}
+	}
+	check(m, s);
+	//unsorted tail and duplicates after a sorted prefix
+	for (int i = 0; i < 20000; ++i)
+		v.push_back(value_type(rnd() % 200000, -i));
+	s.clear();
+	for (size_t i = 0; i < v.size(); ++i)
+		s.insert(std::make_pair(v[i].first, v[i].second));
+	m.assign_sorted(v.begin(), v.end());
+	check(m, s);
+	m.assign_sorted(v.begin(), v.begin());
+	check(m, std::map<int, int>());
+	std::cout << s.size() << std::endl;
+}
+
+int main()
+{
+	TestHint();
+	TestSorted();
+	std::cout << "Passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,127 @@
+#include "map.hpp"
+#include <iostream>
+#include <map>
+#include <utility>
+
+//split_at, merge_union, intersect and difference against std::map
+
+unsigned long long seed = 314159265;
+
+unsigned rnd()
+{
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return seed >> 33;
+}
+
+void error()
+{
+	std::cout << "Error, mismatch found." << std::endl;
+	exit(0);
+}
+
+typedef sjtu::map<int, int> map;
+
+void check(const map &m, const std::map<int, int> &s)
+{
+	if (m.size() != s.size())
+		error();
+	auto it = m.cbegin();
+	size_t k = 0;
+	for (auto jt = s.begin(); jt != s.end(); ++jt, ++it, ++k)
+		if (it == m.cend() || it->first != jt->first || it->second != jt->second || m.rank(jt->first) != k)
+			error();
+	if (it != m.cend())
+		error();
+	for (auto jt = s.rbegin(); jt != s.rend(); ++jt)
+		if ((--it)->first != jt->first)
+			error();
+}
+
+void fill(map &m, std::map<int, int> &s, int n, int range, int tag)
+{
+	for (int i = 0; i < n; ++i) {
+		int key = rnd() % range;
+		m[key] = tag;
+		s[key] = tag;
+	}
+}
+
+void TestSplit()
+{
+	for (int round = 0; round < 20; ++round) {
+		map m;
+		std::map<int, int> s;
+		fill(m, s, rnd() % 20000, 30000, round);
+		int key = rnd() % 32000 - 1000;
+		map r = m.split_at(key);
+		std::map<int, int> sr(s.lower_bound(key), s.end());
+		s.erase(s.lower_bound(key), s.end());
+		check(m, s);
+		check(r, sr);
+		//both halves keep working on the shared pool
+		fill(m, s, 1000, 30000, -1);
+		fill(r, sr, 1000, 30000, -2);
+		r.erase(r.begin());
+		sr.erase(sr.begin());
+		check(m, s);
+		check(r, sr);
+		map moved(std::move(r));
+		check(moved, sr);
+		check(r, std::map<int, int>());
+		r[1] = 1;
+		if (round % 5 == 0)
+			std::cout << s.size() << " " << sr.size() << std::endl;
+	}
+}
+
+void TestSetOps()
+{
+	for (int round = 0; round < 30; ++round) {
+		map a, b;
+		std::map<int, int> sa, sb;
+		int range = 1000 + rnd() % 50000;
+		fill(a, sa, rnd() % 20000, range, 1);
+		fill(b, sb, rnd() % 20000, range, 2);
+		std::map<int, int> expect;
+		switch (round % 3) {
+			case 0:
+				a.merge_union(b);
+				expect = sa;
+				expect.insert(sb.begin(), sb.end());
+				break;
+			case 1:
+				a.intersect(b);
+				for (auto it = sa.begin(); it != sa.end(); ++it)
+					if (sb.count(it->first))
+						expect.insert(*it);
+				break;
+			default:
+				a.difference(b);
+				for (auto it = sa.begin(); it != sa.end(); ++it)
+					if (!sb.count(it->first))
+						expect.insert(*it);
+		}
+		check(a, expect);
+		check(b, sb);
+		fill(a, expect, 1000, range, 3);
+		check(a, expect);
+		if (round % 5 == 0)
+			std::cout << expect.size() << std::endl;
+	}
+	map a;
+	std::map<int, int> sa;
+	fill(a, sa, 1000, 5000, 0);
+	a.merge_union(a);
+	a.intersect(a);
+	check(a, sa);
+	a.difference(a);
+	check(a, std::map<int, int>());
+}
+
+int main()
+{
+	TestSplit();
+	TestSetOps();
+	std::cout << "Passed" << std::endl;
+	return 0;
+}
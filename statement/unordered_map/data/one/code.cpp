@@ -0,0 +1,167 @@
+#include "unordered_map.hpp"
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+//unordered_map against std::unordered_map: random inserts and erases through rehashes and deleted slots
+
+unsigned long long seed = 20201231;
+
+unsigned rnd()
+{
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return seed >> 33;
+}
+
+void error()
+{
+	std::cout << "Error, mismatch found." << std::endl;
+	exit(0);
+}
+
+//every three keys collide
+class Hash {
+public:
+	size_t operator () (int key) const {
+		return std::hash<int>()(key / 3);
+	}
+};
+
+template<class M, class S>
+void check(const M &m, const S &s)
+{
+	if (m.size() != s.size() || m.empty() != s.empty())
+		error();
+	size_t n = 0;
+	for (auto it = m.cbegin(); it != m.cend(); ++it, ++n) {
+		auto jt = s.find(it->first);
+		if (jt == s.end() || jt->second != it->second)
+			error();
+	}
+	if (n != s.size())
+		error();
+}
+
+void TestInt()
+{
+	typedef sjtu::unordered_map<int, std::string, Hash> umap;
+	umap m;
+	std::unordered_map<int, std::string> s;
+	for (int round = 0; round < 10; ++round) {
+		for (int i = 0; i < 30000; ++i) {
+			int key = rnd() % 20000;
+			unsigned op = rnd() % 6;
+			if (op < 2) {
+				m[key] = std::to_string(i);
+				s[key] = std::to_string(i);
+			}
+			else if (op < 3) {
+				bool inserted = m.insert(sjtu::pair<const int, std::string>(key, std::to_string(i))).second;
+				if (inserted != s.insert(std::make_pair(key, std::to_string(i))).second)
+					error();
+			}
+			else if (op < 5) {
+				auto it = m.find(key);
+				if ((it == m.end()) != (s.count(key) == 0))
+					error();
+				if (it != m.end()) {
+					m.erase(it);
+					s.erase(key);
+				}
+			}
+			else {
+				if (m.count(key) != s.count(key))
+					error();
+				try {
+					const std::string &v = m.at(key);
+					if (!s.count(key) || v != s[key])
+						error();
+				} catch (sjtu::index_out_of_bound) {
+					if (s.count(key))
+						error();
+				}
+			}
+		}
+		check(m, s);
+		std::cout << s.size() << std::endl;
+	}
+	umap c(m);
+	check(c, s);
+	c.clear();
+	check(c, std::unordered_map<int, std::string>());
+	c = m;
+	m.clear();
+	check(c, s);
+	try {
+		c.erase(c.end());
+		error();
+	} catch (sjtu::invalid_iterator) {}
+	try {
+		c.erase(m.begin());
+		error();
+	} catch (sjtu::invalid_iterator) {}
+	while (!s.empty()) {
+		s.erase(c.begin()->first);
+		c.erase(c.begin());
+	}
+	check(c, s);
+}
+
+void TestString()
+{
+	sjtu::unordered_map<std::string, int> m;
+	std::unordered_map<std::string, int> s;
+	m.reserve(1000);
+	for (int i = 0; i < 100000; ++i) {
+		std::string key = "key" + std::to_string(rnd() % 50000);
+		if (rnd() % 4 != 0) {
+			m[key] += i;
+			s[key] += i;
+		}
+		else if (m.count(key)) {
+			m.erase(m.find(key));
+			s.erase(key);
+		}
+	}
+	check(m, s);
+	std::cout << s.size() << std::endl;
+}
+
+class Value {
+public:
+	static int built;
+	int val;
+	Value() : val(0) { ++built; }
+	Value(int val) : val(val) { ++built; }
+	Value(const Value &rhs) : val(rhs.val) {}
+};
+
+int Value::built = 0;
+
+//operator[] and try_emplace build T only for a new key
+void TestLazy()
+{
+	sjtu::unordered_map<int, Value> m;
+	for (int i = 0; i < 10000; ++i)
+		m[i % 1000].val += i;
+	if (Value::built != 1000)
+		error();
+	for (int i = 0; i < 10000; ++i) {
+		m[i % 1000].val -= i;
+		m.try_emplace(i % 1000, i);
+	}
+	if (Value::built != 1000)
+		error();
+	m.try_emplace(1000, 5);
+	std::cout << Value::built << " " << m[999].val << " " << m.at(1000).val << std::endl;
+}
+
+int main()
+{
+	TestInt();
+	TestString();
+	TestLazy();
+	std::cout << "Passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,130 @@
+#include "vector.hpp"
+
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+//range insert and erase against std::vector
+
+unsigned long long seed = 4206942069ULL;
+
+unsigned rnd()
+{
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return seed >> 33;
+}
+
+void error()
+{
+	std::cout << "Error, mismatch found." << std::endl;
+	exit(0);
+}
+
+void check(const sjtu::vector<std::string> &v, const std::vector<std::string> &s)
+{
+	if (v.size() != s.size())
+		error();
+	for (size_t i = 0; i < s.size(); ++i)
+		if (v[i] != s[i])
+			error();
+}
+
+void TestEdges()
+{
+	sjtu::vector<std::string> v;
+	std::vector<std::string> s;
+	for (int i = 0; i < 4; ++i) {
+		v.push_back(std::string(30, 'a' + i));
+		s.push_back(std::string(30, 'a' + i));
+	}
+	//empty ranges
+	auto it = v.erase(v.begin() + 1, v.begin() + 1);
+	if (it - v.begin() != 1)
+		error();
+	v.erase(v.begin(), v.begin());
+	v.erase(v.end(), v.end());
+	it = v.insert(v.begin() + 2, 0, std::string("x"));
+	if (it - v.begin() != 2)
+		error();
+	std::list<std::string> none;
+	v.insert(v.begin() + 2, none.begin(), none.end());
+	check(v, s);
+	//at the front and at the back
+	std::list<std::string> l;
+	for (int i = 0; i < 5; ++i)
+		l.push_back(std::string(20, 'p' + i));
+	v.insert(v.begin(), l.begin(), l.end());
+	s.insert(s.begin(), l.begin(), l.end());
+	v.insert(v.end(), l.begin(), l.end());
+	s.insert(s.end(), l.begin(), l.end());
+	v.insert(v.begin(), 3, std::string(25, 'z'));
+	s.insert(s.begin(), 3, std::string(25, 'z'));
+	v.insert(v.end(), 3, std::string(25, 'y'));
+	s.insert(s.end(), 3, std::string(25, 'y'));
+	check(v, s);
+	//the value is an element of the vector
+	v.insert(v.begin() + 1, 100, v[4]);
+	s.insert(s.begin() + 1, 100, std::string(s[4]));
+	check(v, s);
+	v.erase(v.begin(), v.begin() + 7);
+	s.erase(s.begin(), s.begin() + 7);
+	v.erase(v.end() - 7, v.end());
+	s.erase(s.end() - 7, s.end());
+	check(v, s);
+	it = v.erase(v.begin(), v.end());
+	if (it != v.end() || !v.empty())
+		error();
+	v.push_back("last");
+	try {
+		v.erase(v.end(), v.begin());
+		error();
+	} catch (sjtu::invalid_iterator) {}
+	std::cout << "edges ok" << std::endl;
+}
+
+void TestRandom()
+{
+	sjtu::vector<std::string> v;
+	std::vector<std::string> s;
+	for (int i = 0; i < 20000; ++i) {
+		size_t pos = rnd() % (s.size() + 1);
+		unsigned op = rnd() % 3;
+		if (op == 0) {
+			size_t count = rnd() % 8;
+			std::string value(rnd() % 40, 'a' + i % 26);
+			auto it = v.insert(v.begin() + pos, count, value);
+			s.insert(s.begin() + pos, count, value);
+			if (it - v.begin() != (long) pos)
+				error();
+		}
+		else if (op == 1) {
+			std::list<std::string> l;
+			for (size_t k = rnd() % 8; k > 0; --k)
+				l.push_back(std::string(rnd() % 40, 'A' + i % 26));
+			v.insert(v.begin() + pos, l.begin(), l.end());
+			s.insert(s.begin() + pos, l.begin(), l.end());
+		}
+		else {
+			size_t len = rnd() % 12;
+			if (len > s.size() - pos)
+				len = s.size() - pos;
+			auto it = v.erase(v.begin() + pos, v.begin() + pos + len);
+			s.erase(s.begin() + pos, s.begin() + pos + len);
+			if (it - v.begin() != (long) pos)
+				error();
+		}
+		if (i % 1000 == 0)
+			check(v, s);
+	}
+	check(v, s);
+	std::cout << s.size() << std::endl;
+}
+
+int main()
+{
+	TestEdges();
+	TestRandom();
+	std::cout << "Passed" << std::endl;
+	return 0;
+}
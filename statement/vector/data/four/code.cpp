@@ -0,0 +1,43 @@
+#include "vector.hpp"
+
+#include <iostream>
+#include <string>
+
+class Counter {
+public:
+	static int alive;
+	int *val;
+	Counter(int v) : val(new int(v)) { ++alive; }
+	Counter(const Counter &rhs) : val(new int(*rhs.val)) { ++alive; }
+	~Counter() { delete val; --alive; }
+};
+
+int Counter::alive = 0;
+
+int main()
+{
+	{
+		sjtu::vector<Counter> v;
+		for (int i = 0; i < 1000; ++i) {
+			v.push_back(Counter(i));
+			if (i % 3 == 0)
+				v.pop_back();
+		}
+		std::cout << v.size() << " " << *v.back().val << " " << Counter::alive << std::endl;
+		while (!v.empty())
+			v.pop_back();
+		std::cout << v.size() << " " << Counter::alive << std::endl;
+		v.push_back(Counter(1));
+		v.push_back(Counter(2));
+		v.pop_back();
+		std::cout << *v.back().val << " " << Counter::alive << std::endl;
+	}
+	std::cout << Counter::alive << std::endl;
+	sjtu::vector<std::string> s;
+	for (int i = 0; i < 100; ++i)
+		s.push_back(std::string(50, 'a' + i % 26));
+	for (int i = 0; i < 60; ++i)
+		s.pop_back();
+	std::cout << s.size() << " " << s.back() << std::endl;
+	return 0;
+}
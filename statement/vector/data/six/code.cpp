@@ -0,0 +1,59 @@
+#include "vector.hpp"
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+//the allocator is the second template parameter, as in std::vector
+
+long long allocated = 0, calls = 0;
+
+template<class T>
+class Counting {
+public:
+	typedef T value_type;
+	Counting() {}
+	template<class U>
+	Counting(const Counting<U> &) {}
+	T *allocate(size_t n) {
+		allocated += n * sizeof(T);
+		++calls;
+		return std::allocator<T>().allocate(n);
+	}
+	void deallocate(T *p, size_t n) {
+		allocated -= n * sizeof(T);
+		std::allocator<T>().deallocate(p, n);
+	}
+	bool operator == (const Counting &) const { return true; }
+	bool operator != (const Counting &) const { return false; }
+};
+
+int main()
+{
+	{
+		sjtu::vector<std::string, Counting<std::string> > v;
+		for (int i = 0; i < 1000; ++i)
+			v.push_back(std::to_string(i));
+		sjtu::vector<std::string, Counting<std::string> > w(v);
+		std::cout << v.size() << " " << w.back() << " " << (allocated > 0) << std::endl;
+	}
+	std::cout << allocated << std::endl;
+	{
+		calls = 0;
+		sjtu::small_vector<std::string, 4, Counting<std::string> > v;
+		for (int i = 0; i < 4; ++i)
+			v.push_back(std::to_string(i));
+		std::cout << calls << " ";
+		v.push_back("4");
+		std::cout << calls << " " << v.size() << " " << v[4] << std::endl;
+	}
+	std::cout << allocated << std::endl;
+	{
+		sjtu::vector<int, Counting<int>, sjtu::half_growth, sjtu::unchecked_access> v;
+		for (int i = 0; i < 100; ++i)
+			v.push_back(i);
+		std::cout << v[99] << std::endl;
+	}
+	std::cout << allocated << std::endl;
+	return 0;
+}
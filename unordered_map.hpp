@@ -0,0 +1,600 @@
+/**
+ * implement a container like std::unordered_map
+ */
+#ifndef SJTU_UNORDERED_MAP_HPP
+#define SJTU_UNORDERED_MAP_HPP
+
+// only for std::hash<T> and std::equal_to<T>
+#include <functional>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu
+{
+
+/**
+ * a hash map with open addressing in the style of a Swiss table.
+ * every slot has a control byte: empty, deleted, or the low 7 bits of the hash of its key.
+ * a lookup compares 16 control bytes at once (with SSE2 when it is available) and only
+ *   calls KeyEqual on the slots whose byte matches, stopping at the first group with an
+ *   empty slot.
+ * the table grows to twice its capacity when it is 7/8 full (deleted slots included).
+ * insert may rehash and invalidate every iterator, erase invalidates none but pos.
+ */
+template<class Key, class T, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>, class Allocator = std::allocator<pair<const Key, T> > >
+class unordered_map
+{
+public:
+	typedef pair<const Key, T> value_type;
+	class iterator;
+	class const_iterator;
+private:
+	typedef signed char ctrl_t;
+	static const ctrl_t ctrlEmpty = -128, ctrlDeleted = -2;
+	static const size_t width = 16, minCapacity = 16;
+	/**
+	 * 16 consecutive control bytes.
+	 * every match returns a bit mask whose i-th bit stands for the i-th byte.
+	 */
+	struct group
+	{
+#ifdef __SSE2__
+		__m128i ctrl;
+		explicit group(const ctrl_t *p) : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+		unsigned match(ctrl_t h) const
+		{
+			return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h), ctrl));
+		}
+		//empty and deleted are the bytes with the sign bit
+		unsigned matchFree() const
+		{
+			return _mm_movemask_epi8(ctrl);
+		}
+#else
+		const ctrl_t *ctrl;
+		explicit group(const ctrl_t *p) : ctrl(p) {}
+		unsigned match(ctrl_t h) const
+		{
+			unsigned ret = 0;
+			for (size_t i = 0; i < width; ++i)
+				ret |= unsigned(ctrl[i] == h) << i;
+			return ret;
+		}
+		unsigned matchFree() const
+		{
+			unsigned ret = 0;
+			for (size_t i = 0; i < width; ++i)
+				ret |= unsigned(ctrl[i] < 0) << i;
+			return ret;
+		}
+#endif
+		unsigned matchEmpty() const
+		{
+			return match(ctrlEmpty);
+		}
+	};
+	static size_t lowestBit(unsigned mask)
+	{
+#ifdef __GNUC__
+		return __builtin_ctz(mask);
+#else
+		size_t ret = 0;
+		while (!(mask >> ret & 1))
+			++ret;
+		return ret;
+#endif
+	}
+	typedef std::allocator_traits<Allocator> alloc_traits;
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<ctrl_t> ctrl_allocator;
+	typedef std::allocator_traits<ctrl_allocator> ctrl_traits;
+
+	/**
+	 * ctrl has capacity + width bytes: the last width ones copy the first ones,
+	 *   so a group can be read from any slot without wrapping around.
+	 * capacity is 0 or a power of 2 not less than minCapacity.
+	 */
+	ctrl_t *ctrl;
+	value_type *slots;
+	size_t capacity, dataSize;
+	//the number of empty slots that can still be filled before the table grows
+	size_t growthLeft;
+	Hash hf;
+	KeyEqual eq;
+	Allocator alloc;
+	ctrl_allocator ctrlAlloc;
+
+	static size_t maxLoad(size_t cap)
+	{
+		return cap - cap / 8;
+	}
+	//spread the bits of the user hash, std::hash of integers is usually the identity
+	size_t hashOf(const Key &key) const
+	{
+		size_t h = hf(key) * size_t(0x9E3779B97F4A7C15ull);
+		return h ^ (h >> (sizeof(size_t) * 4));
+	}
+	static ctrl_t h2(size_t hash)
+	{
+		return ctrl_t(hash & 0x7F);
+	}
+	void setCtrl(size_t i, ctrl_t h)
+	{
+		ctrl[i] = h;
+		if (i < width)
+			ctrl[capacity + i] = h;
+	}
+	bool full(size_t i) const
+	{
+		return ctrl[i] >= 0;
+	}
+	//the first full slot from i, capacity if none
+	size_t skip(size_t i) const
+	{
+		while (i < capacity && !full(i))
+			++i;
+		return i;
+	}
+	void init()
+	{
+		ctrl = nullptr;
+		slots = nullptr;
+		capacity = dataSize = growthLeft = 0;
+	}
+	//switch to a new table of cap empty slots, the old one is left to the caller
+	void allocate(size_t cap)
+	{
+		ctrl_t *tmp = ctrl_traits::allocate(ctrlAlloc, cap + width);
+		try
+		{
+			slots = alloc_traits::allocate(alloc, cap);
+		}
+		catch (...)
+		{
+			ctrl_traits::deallocate(ctrlAlloc, tmp, cap + width);
+			throw;
+		}
+		ctrl = tmp;
+		std::memset(ctrl, ctrlEmpty, cap + width);
+		capacity = cap;
+		growthLeft = maxLoad(cap) - dataSize;
+	}
+	//destroy every element and return the table
+	void release()
+	{
+		if (capacity == 0)
+			return;
+		for (size_t i = 0; i < capacity; ++i)
+			if (full(i))
+				slots[i].~value_type();
+		ctrl_traits::deallocate(ctrlAlloc, ctrl, capacity + width);
+		alloc_traits::deallocate(alloc, slots, capacity);
+		init();
+	}
+	//the first free slot on the probe sequence of hash
+	size_t findFree(size_t hash) const
+	{
+		size_t mask = capacity - 1, pos = (hash >> 7) & mask;
+		for (size_t step = width; ; pos = (pos + step) & mask, step += width)
+		{
+			unsigned m = group(ctrl + pos).matchFree();
+			if (m != 0)
+				return (pos + lowestBit(m)) & mask;
+		}
+	}
+	//the slot of key, capacity if key does not exist
+	size_t locate(const Key &key, size_t hash) const
+	{
+		if (capacity == 0)
+			return capacity;
+		size_t mask = capacity - 1, pos = (hash >> 7) & mask;
+		for (size_t step = width; ; pos = (pos + step) & mask, step += width)
+		{
+			group g(ctrl + pos);
+			for (unsigned m = g.match(h2(hash)); m != 0; m &= m - 1)
+			{
+				size_t i = (pos + lowestBit(m)) & mask;
+				if (eq(slots[i].first, key))
+					return i;
+			}
+			if (g.matchEmpty() != 0)
+				return capacity;
+		}
+	}
+	//move every element to a table of cap slots, which drops the deleted ones
+	void rehash(size_t cap)
+	{
+		ctrl_t *exCtrl = ctrl;
+		value_type *exSlots = slots;
+		size_t exCapacity = capacity;
+		allocate(cap);
+		for (size_t i = 0; i < exCapacity; ++i)
+			if (exCtrl[i] >= 0)
+			{
+				size_t hash = hashOf(exSlots[i].first), j = findFree(hash);
+				new(slots + j) value_type(std::move(exSlots[i]));
+				exSlots[i].~value_type();
+				setCtrl(j, h2(hash));
+			}
+		if (exCapacity != 0)
+		{
+			ctrl_traits::deallocate(ctrlAlloc, exCtrl, exCapacity + width);
+			alloc_traits::deallocate(alloc, exSlots, exCapacity);
+		}
+	}
+	/**
+	 * put value_type(args...) for a key which does not exist (locate has missed it),
+	 *   hash is the hash of the key. return the slot of the new element.
+	 */
+	template<class... Args>
+	size_t putNew(size_t hash, Args&&... args)
+	{
+		if (capacity == 0)
+			rehash(minCapacity);
+		size_t i = findFree(hash);
+		if (ctrl[i] == ctrlEmpty && growthLeft == 0)
+		{
+			//rehash in place if most of the used slots are deleted
+			rehash(dataSize * 2 >= maxLoad(capacity) ? capacity * 2 : capacity);
+			i = findFree(hash);
+		}
+		new(slots + i) value_type(std::forward<Args>(args)...);
+		if (ctrl[i] == ctrlEmpty)
+			--growthLeft;
+		setCtrl(i, h2(hash));
+		++dataSize;
+		return i;
+	}
+	/**
+	 * put value_type(args...) for key if key does not exist.
+	 * return the slot of key and whether it is new.
+	 */
+	template<class... Args>
+	pair<size_t, bool> put(const Key &key, Args&&... args)
+	{
+		size_t hash = hashOf(key), i = locate(key, hash);
+		if (i != capacity)
+			return pair<size_t, bool>(i, 0);
+		return pair<size_t, bool>(putNew(hash, std::forward<Args>(args)...), 1);
+	}
+	void copy(const unordered_map &other)
+	{
+		init();
+		if (other.dataSize == 0)
+			return;
+		allocate(other.capacity);
+		for (size_t i = 0; i < other.capacity; ++i)
+			if (other.full(i))
+			{
+				new(slots + i) value_type(other.slots[i]);
+				setCtrl(i, other.ctrl[i]);
+				++dataSize;
+			}
+		//the elements keep their slots, so the deleted ones have to stay deleted as well
+		std::memcpy(ctrl, other.ctrl, capacity + width);
+		growthLeft = other.growthLeft;
+	}
+public:
+	/**
+	 * see ForwardIterator at CppReference for help, -- is provided as well.
+	 *
+	 * if there is anything wrong throw invalid_iterator.
+	 *     like it = map.begin(); --it;
+	 *       or it = map.end(); ++end();
+	 */
+	class iterator
+	{
+		friend unordered_map;
+	private:
+		unordered_map *mp;
+		size_t ind;
+		iterator(unordered_map *_mp, size_t _ind) : mp(_mp), ind(_ind) {}
+	public:
+		iterator() : mp(nullptr), ind(0) {}
+		iterator(const iterator &other) : mp(other.mp), ind(other.ind) {}
+		iterator operator++(int)
+		{
+			iterator ret(*this);
+			++*this;
+			return ret;
+		}
+		iterator & operator++()
+		{
+			if (ind == mp->capacity)
+				throw invalid_iterator();
+			ind = mp->skip(ind + 1);
+			return *this;
+		}
+		iterator operator--(int)
+		{
+			iterator ret(*this);
+			--*this;
+			return ret;
+		}
+		iterator & operator--()
+		{
+			size_t i = ind;
+			do
+			{
+				if (i == 0)
+					throw invalid_iterator();
+			} while (!mp->full(--i));
+			ind = i;
+			return *this;
+		}
+		value_type & operator*() const
+		{
+			return mp->slots[ind];
+		}
+		bool operator==(const iterator &rhs) const
+		{
+			return mp == rhs.mp && ind == rhs.ind;
+		}
+		bool operator==(const const_iterator &rhs) const
+		{
+			return mp == rhs.mp && ind == rhs.ind;
+		}
+		bool operator!=(const iterator &rhs) const
+		{
+			return mp != rhs.mp || ind != rhs.ind;
+		}
+		bool operator!=(const const_iterator &rhs) const
+		{
+			return mp != rhs.mp || ind != rhs.ind;
+		}
+		value_type* operator->() const noexcept
+		{
+			return mp->slots + ind;
+		}
+	};
+	class const_iterator
+	{
+		friend unordered_map;
+	private:
+		const unordered_map *mp;
+		size_t ind;
+		const_iterator(const unordered_map *_mp, size_t _ind) : mp(_mp), ind(_ind) {}
+	public:
+		const_iterator() : mp(nullptr), ind(0) {}
+		const_iterator(const const_iterator &other) : mp(other.mp), ind(other.ind) {}
+		const_iterator(const iterator &other) : mp(other.mp), ind(other.ind) {}
+		const_iterator operator++(int)
+		{
+			const_iterator ret(*this);
+			++*this;
+			return ret;
+		}
+		const_iterator & operator++()
+		{
+			if (ind == mp->capacity)
+				throw invalid_iterator();
+			ind = mp->skip(ind + 1);
+			return *this;
+		}
+		const_iterator operator--(int)
+		{
+			const_iterator ret(*this);
+			--*this;
+			return ret;
+		}
+		const_iterator & operator--()
+		{
+			size_t i = ind;
+			do
+			{
+				if (i == 0)
+					throw invalid_iterator();
+			} while (!mp->full(--i));
+			ind = i;
+			return *this;
+		}
+		const value_type & operator*() const
+		{
+			return mp->slots[ind];
+		}
+		bool operator==(const iterator &rhs) const
+		{
+			return mp == rhs.mp && ind == rhs.ind;
+		}
+		bool operator==(const const_iterator &rhs) const
+		{
+			return mp == rhs.mp && ind == rhs.ind;
+		}
+		bool operator!=(const iterator &rhs) const
+		{
+			return mp != rhs.mp || ind != rhs.ind;
+		}
+		bool operator!=(const const_iterator &rhs) const
+		{
+			return mp != rhs.mp || ind != rhs.ind;
+		}
+		const value_type* operator->() const noexcept
+		{
+			return mp->slots + ind;
+		}
+	};
+
+	unordered_map()
+	{
+		init();
+	}
+	explicit unordered_map(size_t n, const Hash &_hf = Hash(), const KeyEqual &_eq = KeyEqual(), const Allocator &_alloc = Allocator())
+		: hf(_hf), eq(_eq), alloc(_alloc), ctrlAlloc(_alloc)
+	{
+		init();
+		reserve(n);
+	}
+	unordered_map(const unordered_map &other) : hf(other.hf), eq(other.eq), alloc(other.alloc), ctrlAlloc(other.ctrlAlloc)
+	{
+		copy(other);
+	}
+	unordered_map & operator=(const unordered_map &other)
+	{
+		if (this == &other)
+			return *this;
+		release();
+		copy(other);
+		return *this;
+	}
+	~unordered_map()
+	{
+		release();
+	}
+	/**
+	 * access specified element with bounds checking
+	 * If no such element exists, an exception of type `index_out_of_bound'
+	 */
+	T & at(const Key &key)
+	{
+		size_t i = locate(key, hashOf(key));
+		if (i == capacity)
+			throw index_out_of_bound();
+		return slots[i].second;
+	}
+	const T & at(const Key &key) const
+	{
+		size_t i = locate(key, hashOf(key));
+		if (i == capacity)
+			throw index_out_of_bound();
+		return slots[i].second;
+	}
+	/**
+	 * access specified element, performing an insertion if such key does not already exist.
+	 */
+	T & operator[](const Key &key)
+	{
+		//T() is only built for a new key, and putNew may rehash, so slots is read after it
+		size_t hash = hashOf(key), i = locate(key, hash);
+		if (i == capacity)
+			i = putNew(hash, key, T());
+		return slots[i].second;
+	}
+	/**
+	 * behave like at() throw index_out_of_bound if such key does not exist.
+	 */
+	const T & operator[](const Key &key) const
+	{
+		return at(key);
+	}
+	/**
+	 * begin() skips the empty slots at the front of the table, O(capacity) in the worst case.
+	 */
+	iterator begin()
+	{
+		return iterator(this, skip(0));
+	}
+	const_iterator cbegin() const
+	{
+		return const_iterator(this, skip(0));
+	}
+	iterator end()
+	{
+		return iterator(this, capacity);
+	}
+	const_iterator cend() const
+	{
+		return const_iterator(this, capacity);
+	}
+	bool empty() const
+	{
+		return dataSize == 0;
+	}
+	size_t size() const
+	{
+		return dataSize;
+	}
+	//the number of slots
+	size_t bucket_count() const
+	{
+		return capacity;
+	}
+	/**
+	 * make room for n elements without rehashing.
+	 */
+	void reserve(size_t n)
+	{
+		size_t cap = capacity == 0 ? minCapacity : capacity;
+		while (maxLoad(cap) < n)
+			cap *= 2;
+		if (cap != capacity)
+			rehash(cap);
+	}
+	Allocator get_allocator() const
+	{
+		return alloc;
+	}
+	/**
+	 * destroy every element, the capacity is kept.
+	 */
+	void clear()
+	{
+		for (size_t i = 0; i < capacity; ++i)
+			if (full(i))
+				slots[i].~value_type();
+		if (capacity != 0)
+			std::memset(ctrl, ctrlEmpty, capacity + width);
+		dataSize = 0;
+		growthLeft = maxLoad(capacity);
+	}
+	/**
+	 * insert an element, return the same as sjtu::map::insert.
+	 */
+	pair<iterator, bool> insert(const value_type &value)
+	{
+		pair<size_t, bool> ret = put(value.first, value);
+		return pair<iterator, bool>(iterator(this, ret.first), ret.second);
+	}
+	pair<iterator, bool> insert(value_type &&value)
+	{
+		pair<size_t, bool> ret = put(value.first, std::move(value));
+		return pair<iterator, bool>(iterator(this, ret.first), ret.second);
+	}
+	/**
+	 * if key does not exist, insert (key, T(args...)), otherwise do nothing.
+	 */
+	template<class... Args>
+	pair<iterator, bool> try_emplace(const Key &key, Args&&... args)
+	{
+		size_t hash = hashOf(key), i = locate(key, hash);
+		if (i != capacity)
+			return pair<iterator, bool>(iterator(this, i), 0);
+		i = putNew(hash, key, T(std::forward<Args>(args)...));
+		return pair<iterator, bool>(iterator(this, i), 1);
+	}
+	/**
+	 * erase the element at pos, the slot is left deleted until the next rehash.
+	 *
+	 * throw if pos pointed to a bad element (pos == this->end() || pos points an element out of this)
+	 */
+	void erase(iterator pos)
+	{
+		if (pos.mp != this || pos.ind >= capacity || !full(pos.ind))
+			throw invalid_iterator();
+		slots[pos.ind].~value_type();
+		setCtrl(pos.ind, ctrlDeleted);
+		--dataSize;
+	}
+	size_t count(const Key &key) const
+	{
+		return locate(key, hashOf(key)) != capacity;
+	}
+	iterator find(const Key &key)
+	{
+		return iterator(this, locate(key, hashOf(key)));
+	}
+	const_iterator find(const Key &key) const
+	{
+		return const_iterator(this, locate(key, hashOf(key)));
+	}
+};
+
+}
+
+#endif
@@ -5,28 +5,288 @@
 
 #include <climits>
 #include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace sjtu
 {
+#ifndef SJTU_IS_TRIVIALLY_RELOCATABLE
+#define SJTU_IS_TRIVIALLY_RELOCATABLE
+/**
+ * whether an object of T can be moved to another address by a plain memmove
+ *   (and the old one forgotten without calling the destructor).
+ * true for trivially copyable types, specialize it for classes which never
+ *   hold pointers into themselves to get the bulk path.
+ * vector and deque both declare it, the guard keeps it to one definition.
+ */
+template<typename T>
+struct is_trivially_relocatable : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+#endif
+
+/**
+ * growth policies of vector, grow() returns the new capacity when it is full.
+ */
+struct double_growth
+{
+	static size_t grow(const size_t &cap)
+	{
+		return cap * 2;
+	}
+};
+struct half_growth
+{
+	static size_t grow(const size_t &cap)
+	{
+		return cap + cap / 2 + 1;
+	}
+};
+
+/**
+ * access policies of vector::operator[], check() is called before every access.
+ * at() always checks the boundary.
+ */
+struct checked_access
+{
+	static void check(const size_t &pos, const size_t &size)
+	{
+		if (pos >= size)
+			throw index_out_of_bound();
+	}
+};
+struct unchecked_access
+{
+	static void check(const size_t &, const size_t &) {}
+};
+
+/**
+ * the inline storage of a vector which can hold N elements without allocating.
+ * empty if N == 0.
+ */
+template<typename T, size_t N>
+class inline_storage
+{
+private:
+	typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buf;
+protected:
+	T *inline_data()
+	{
+		return (T*) &buf;
+	}
+};
+template<typename T>
+class inline_storage<T, 0>
+{
+protected:
+	T *inline_data()
+	{
+		return nullptr;
+	}
+};
+
 /**
  * a data container like std::vector
  * store data in a successive memory and support random access.
+ * the first N elements are stored inside the vector itself (see small_vector),
+ *   it only allocates when the size exceeds N.
+ * the storage is obtained from Allocator (only allocate and deallocate are used).
  */
-template<typename T>
-class vector
+template<typename T, class Allocator = std::allocator<T>, class Growth = double_growth, class Access = checked_access, size_t N = 0>
+class vector : private inline_storage<T, N>
 {
 
+public:
+	/**
+	 * telemetry of the storage, see stats().
+	 */
+	struct statistics
+	{
+		size_t reallocations;
+		size_t bytesCopied;
+		size_t peakCapacity;
+		statistics() : reallocations(0), bytesCopied(0), peakCapacity(0) {}
+	};
+
 private:
 	T *arr;
 	size_t arrSize, dataSize;
-	void expand()
+	statistics counter;
+	Allocator alloc;
+	typedef std::allocator_traits<Allocator> alloc_traits;
+	/**
+	 * move n elements from src to dst, the old ones are destroyed.
+	 * the two ranges may overlap.
+	 */
+	static void relocate(T *dst, T *src, size_t n, std::true_type)
+	{
+		if (n != 0)
+			memmove((void*) dst, (void*) src, sizeof(T) * n);
+	}
+	static void relocate(T *dst, T *src, size_t n, std::false_type)
+	{
+		if (dst == src)
+			return;
+		if (dst < src)
+		{
+			for (size_t i = 0; i < n; ++i)
+			{
+				new(&dst[i]) T(std::move(src[i]));
+				src[i].~T();
+			}
+		}
+		else
+		{
+			for (size_t i = n; i > 0; --i)
+			{
+				new(&dst[i - 1]) T(std::move(src[i - 1]));
+				src[i - 1].~T();
+			}
+		}
+	}
+	static void relocate(T *dst, T *src, size_t n)
 	{
-		arrSize *= 2;
-		T *ex_arr = (T*) ::operator new (sizeof(T) * arrSize);
-		for (int i = 0; i < dataSize; ++i)
-			memcpy(&ex_arr[i], &arr[i], sizeof(T));
-		::operator delete(arr);
+		relocate(dst, src, n, is_trivially_relocatable<T>());
+	}
+	/**
+	 * move the elements into a new storage which can hold cap elements.
+	 * cap should not be less than dataSize.
+	 */
+	void reallocate(size_t cap)
+	{
+		adopt(alloc_traits::allocate(alloc, cap), cap);
+	}
+	/**
+	 * move the elements into ex_arr (which can hold cap elements) and release the old storage.
+	 * if n > 0, the elements in [ind, size) are moved n positions back,
+	 *   leaving [ind, ind + n) of ex_arr uninitialized.
+	 */
+	void adopt(T *ex_arr, size_t cap, size_t ind = 0, size_t n = 0)
+	{
+		relocate(ex_arr, arr, ind);
+		relocate(ex_arr + ind + n, arr + ind, dataSize - ind);
+		release();
 		arr = ex_arr;
+		arrSize = cap;
+		++counter.reallocations;
+		counter.bytesCopied += sizeof(T) * dataSize;
+		if (arrSize > counter.peakCapacity)
+			counter.peakCapacity = arrSize;
+	}
+	void expand()
+	{
+		reallocate(Growth::grow(arrSize));
+	}
+	/**
+	 * construct a new element at index ind from args.
+	 * args may refer to an element of this vector, so the new element is built
+	 *   before any element is moved.
+	 */
+	template<class... Args>
+	void emplace_at(size_t ind, Args&&... args)
+	{
+		if (ind == dataSize)
+		{
+			if (dataSize == arrSize)
+			{
+				size_t cap = Growth::grow(arrSize);
+				T *ex_arr = alloc_traits::allocate(alloc, cap);
+				try
+				{
+					new(&ex_arr[dataSize]) T(std::forward<Args>(args)...);
+				}
+				catch (...)
+				{
+					alloc_traits::deallocate(alloc, ex_arr, cap);
+					throw;
+				}
+				adopt(ex_arr, cap);
+			}
+			else
+				new(&arr[dataSize]) T(std::forward<Args>(args)...);
+			++dataSize;
+			return;
+		}
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type buf;
+		T *tmp = new(&buf) T(std::forward<Args>(args)...);
+		if (dataSize == arrSize)
+		{
+			try
+			{
+				expand();
+			}
+			catch (...)
+			{
+				tmp->~T();
+				throw;
+			}
+		}
+		relocate(arr + ind + 1, arr + ind, dataSize - ind);
+		relocate(arr + ind, tmp, 1);
+		++dataSize;
+	}
+	/**
+	 * move the elements in [ind, size) n positions back (reallocate if necessary),
+	 *   leaving [ind, ind + n) uninitialized. dataSize is not changed.
+	 */
+	void open_gap(size_t ind, size_t n)
+	{
+		if (dataSize + n > arrSize)
+		{
+			size_t cap = Growth::grow(arrSize);
+			if (cap < dataSize + n)
+				cap = dataSize + n;
+			adopt(alloc_traits::allocate(alloc, cap), cap, ind, n);
+		}
+		else
+			relocate(arr + ind + n, arr + ind, dataSize - ind);
+	}
+	/**
+	 * free the storage unless it is the inline one.
+	 */
+	void release()
+	{
+		if (arr != this->inline_data())
+			alloc_traits::deallocate(alloc, arr, arrSize);
+	}
+	/**
+	 * use the inline storage if there is one, otherwise allocate one element.
+	 */
+	void init()
+	{
+		if (N > 0)
+		{
+			arr = this->inline_data();
+			arrSize = N;
+		}
+		else
+		{
+			arr = alloc_traits::allocate(alloc, 1);
+			arrSize = 1;
+		}
+		dataSize = 0;
+		counter.peakCapacity = arrSize;
+	}
+	/**
+	 * copy construct the elements of other at the end.
+	 */
+	void append(const vector &other)
+	{
+		reserve(dataSize + other.dataSize);
+		for (size_t i = 0; i < other.dataSize; ++i)
+			new(&arr[dataSize + i]) T(other.arr[i]);
+		dataSize += other.dataSize;
+	}
+	/**
+	 * destroy the elements in [pos, size)
+	 */
+	void destroy(size_t pos)
+	{
+		for (size_t i = pos; i < dataSize; ++i)
+			arr[i].~T();
+		dataSize = pos;
 	}
 public:
 	/**
@@ -46,40 +306,54 @@ public:
 		 * TODO add data members
 		 *   just add whatever you want.
 		 */
-		int index;
-		vector<T> *vec;
+		T *ptr;
+		vector *vec;
 
-		iterator(vector<T> *_vec = nullptr, int _index = 0) : vec(_vec), index(_index) {};
+		iterator(vector *_vec, T *_ptr) : ptr(_ptr), vec(_vec) {};
 	public:
+		/**
+		 * the iterator is a plain pointer to the element in the successive storage,
+		 *   so it satisfies the requirements of contiguous iterators.
+		 */
+		typedef std::random_access_iterator_tag iterator_category;
+#if __cplusplus > 201703L
+		typedef std::contiguous_iterator_tag iterator_concept;
+#endif
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef T* pointer;
+		typedef T& reference;
+
+		iterator() : ptr(nullptr), vec(nullptr) {}
 		/**
 		 * return a new iterator which pointer n-next elements
 		 *   even if there are not enough elements, just return the answer.
 		 * as well as operator-
 		 */
-		iterator operator+(const int &n) const
+		iterator operator+(const difference_type &n) const
 		{
-			return iterator(vec, index + n);
+			return iterator(vec, ptr + n);
 		}
-		iterator operator-(const int &n) const
+		iterator operator-(const difference_type &n) const
 		{
-			return iterator(vec, index - n);
+			return iterator(vec, ptr - n);
 		}
 		// return th distance between two iterator,
 		// if these two iterators points to different vectors, throw invaild_iterator.
-		int operator-(const iterator &rhs) const
+		difference_type operator-(const iterator &rhs) const
 		{
 			if (vec != rhs.vec)
 				throw invalid_iterator();
-			return index - rhs.index;
+			return ptr - rhs.ptr;
 		}
-		iterator operator+=(const int &n)
+		iterator& operator+=(const difference_type &n)
 		{
-			index += n;
+			ptr += n;
 			return *this;
 		}
-		iterator operator-=(const int &n)
+		iterator& operator-=(const difference_type &n)
 		{
-			index -= n;
+			ptr -= n;
 			return *this;
 		}
 		/**
@@ -87,15 +361,16 @@ public:
 		 */
 		iterator operator++(int)
 		{
-			++index;
-			return iterator(vec, index);
+			iterator ret(*this);
+			++ptr;
+			return ret;
 		}
 		/**
 		 * TODO ++iter
 		 */
 		iterator& operator++()
 		{
-			++index;
+			++ptr;
 			return *this;
 		}
 		/**
@@ -103,15 +378,16 @@ public:
 		 */
 		iterator operator--(int)
 		{
-			--index;
-			return iterator(vec, index);
+			iterator ret(*this);
+			--ptr;
+			return ret;
 		}
 		/**
 		 * TODO --iter
 		 */
 		iterator& operator--()
 		{
-			--index;
+			--ptr;
 			return *this;
 		}
 		/**
@@ -119,29 +395,57 @@ public:
 		 */
 		T& operator*() const
 		{
-			return vec->arr[index];
+			return *ptr;
+		}
+		T* operator->() const
+		{
+			return ptr;
+		}
+		T& operator[](const difference_type &n) const
+		{
+			return ptr[n];
 		}
 		/**
 		 * a operator to check whether two iterators are same (pointing to the same memory).
 		 */
 		bool operator==(const iterator &rhs) const
 		{
-			return vec == rhs.vec && index == rhs.index;
+			return vec == rhs.vec && ptr == rhs.ptr;
 		}
 		bool operator==(const const_iterator &rhs) const
 		{
-			return vec == rhs.vec && index == rhs.index;
+			return vec == rhs.vec && ptr == rhs.ptr;
 		}
 		/**
 		 * some other operator for iterator.
 		 */
 		bool operator!=(const iterator &rhs) const
 		{
-			return vec != rhs.vec || index != rhs.index;
+			return vec != rhs.vec || ptr != rhs.ptr;
 		}
 		bool operator!=(const const_iterator &rhs) const
 		{
-			return vec != rhs.vec || index != rhs.index;
+			return vec != rhs.vec || ptr != rhs.ptr;
+		}
+		bool operator<(const iterator &rhs) const
+		{
+			return ptr < rhs.ptr;
+		}
+		bool operator>(const iterator &rhs) const
+		{
+			return ptr > rhs.ptr;
+		}
+		bool operator<=(const iterator &rhs) const
+		{
+			return ptr <= rhs.ptr;
+		}
+		bool operator>=(const iterator &rhs) const
+		{
+			return ptr >= rhs.ptr;
+		}
+		friend iterator operator+(const difference_type &n, const iterator &rhs)
+		{
+			return rhs + n;
 		}
 	};
 	/**
@@ -156,40 +460,55 @@ public:
 		 * TODO add data members
 		 *   just add whatever you want.
 		 */
-		int index;
-		const vector<T> *vec;
+		const T *ptr;
+		const vector *vec;
 
-		const_iterator(const vector<T> *_vec = nullptr, int _index = 0) : vec(_vec), index(_index) {};
+		const_iterator(const vector *_vec, const T *_ptr) : ptr(_ptr), vec(_vec) {};
 	public:
+		/**
+		 * the iterator is a plain pointer to the element in the successive storage,
+		 *   so it satisfies the requirements of contiguous iterators.
+		 */
+		typedef std::random_access_iterator_tag iterator_category;
+#if __cplusplus > 201703L
+		typedef std::contiguous_iterator_tag iterator_concept;
+#endif
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const T* pointer;
+		typedef const T& reference;
+
+		const_iterator() : ptr(nullptr), vec(nullptr) {}
+		const_iterator(const iterator &other) : ptr(other.ptr), vec(other.vec) {}
 		/**
 		 * return a new iterator which pointer n-next elements
 		 *   even if there are not enough elements, just return the answer.
 		 * as well as operator-
 		 */
-		const_iterator operator+(const int &n) const
+		const_iterator operator+(const difference_type &n) const
 		{
-			return const_iterator(vec, index + n);
+			return const_iterator(vec, ptr + n);
 		}
-		const_iterator operator-(const int &n) const
+		const_iterator operator-(const difference_type &n) const
 		{
-			return const_iterator(vec, index - n);
+			return const_iterator(vec, ptr - n);
 		}
 		// return th distance between two iterator,
 		// if these two iterators points to different vectors, throw invaild_iterator.
-		int operator-(const const_iterator &rhs) const
+		difference_type operator-(const const_iterator &rhs) const
 		{
 			if (vec != rhs.vec)
 				throw invalid_iterator();
-			return index - rhs.index;
+			return ptr - rhs.ptr;
 		}
-		const_iterator operator+=(const int &n)
+		const_iterator& operator+=(const difference_type &n)
 		{
-			index += n;
+			ptr += n;
 			return *this;
 		}
-		const_iterator operator-=(const int &n)
+		const_iterator& operator-=(const difference_type &n)
 		{
-			index -= n;
+			ptr -= n;
 			return *this;
 		}
 		/**
@@ -197,15 +516,16 @@ public:
 		 */
 		const_iterator operator++(int)
 		{
-			++index;
-			return const_iterator(vec, index);
+			const_iterator ret(*this);
+			++ptr;
+			return ret;
 		}
 		/**
 		 * TODO ++iter
 		 */
 		const_iterator& operator++()
 		{
-			++index;
+			++ptr;
 			return *this;
 		}
 		/**
@@ -213,15 +533,16 @@ public:
 		 */
 		const_iterator operator--(int)
 		{
-			--index;
-			return const_iterator(vec, index);
+			const_iterator ret(*this);
+			--ptr;
+			return ret;
 		}
 		/**
 		 * TODO --iter
 		 */
 		const_iterator& operator--()
 		{
-			--index;
+			--ptr;
 			return *this;
 		}
 		/**
@@ -229,29 +550,57 @@ public:
 		 */
 		const T& operator*() const
 		{
-			return vec->arr[index];
+			return *ptr;
+		}
+		const T* operator->() const
+		{
+			return ptr;
+		}
+		const T& operator[](const difference_type &n) const
+		{
+			return ptr[n];
 		}
 		/**
 		 * a operator to check whether two iterators are same (pointing to the same memory).
 		 */
 		bool operator==(const iterator &rhs) const
 		{
-			return vec == rhs.vec && index == rhs.index;
+			return vec == rhs.vec && ptr == rhs.ptr;
 		}
 		bool operator==(const const_iterator &rhs) const
 		{
-			return vec == rhs.vec && index == rhs.index;
+			return vec == rhs.vec && ptr == rhs.ptr;
 		}
 		/**
 		 * some other operator for iterator.
 		 */
 		bool operator!=(const iterator &rhs) const
 		{
-			return vec != rhs.vec || index != rhs.index;
+			return vec != rhs.vec || ptr != rhs.ptr;
 		}
 		bool operator!=(const const_iterator &rhs) const
 		{
-			return vec != rhs.vec || index != rhs.index;
+			return vec != rhs.vec || ptr != rhs.ptr;
+		}
+		bool operator<(const const_iterator &rhs) const
+		{
+			return ptr < rhs.ptr;
+		}
+		bool operator>(const const_iterator &rhs) const
+		{
+			return ptr > rhs.ptr;
+		}
+		bool operator<=(const const_iterator &rhs) const
+		{
+			return ptr <= rhs.ptr;
+		}
+		bool operator>=(const const_iterator &rhs) const
+		{
+			return ptr >= rhs.ptr;
+		}
+		friend const_iterator operator+(const difference_type &n, const const_iterator &rhs)
+		{
+			return rhs + n;
 		}
 
 	};
@@ -261,26 +610,24 @@ public:
 	 */
 	vector()
 	{
-		arr = (T*) ::operator new (sizeof(T));
-		arrSize = 1;
-		dataSize = 0;
+		init();
+	}
+	explicit vector(const Allocator &_alloc) : alloc(_alloc)
+	{
+		init();
 	}
-	vector(const vector &other)
+	vector(const vector &other) : alloc(other.alloc)
 	{
-		arrSize = other.arrSize;
-		arr = (T*) ::operator new (sizeof(T) * arrSize);
-		dataSize = other.dataSize;
-		for (int i = 0; i < other.dataSize; ++i)
-			memcpy(&arr[i], &other.arr[i], sizeof(T));
+		init();
+		append(other);
 	}
 	/**
 	 * TODO Destructor
 	 */
 	~vector()
 	{
-		for (int i = 0; i < dataSize; i++)
-			arr[i].~T();
-		::operator delete(arr); 
+		destroy(0);
+		release();
 	}
 	/**
 	 * TODO Assignment operator
@@ -289,15 +636,8 @@ public:
 	{
 		if (this == &other)
 			return *this;
-		if (arrSize < other.arrSize)
-		{
-			arrSize = other.arrSize;
-			::operator delete(arr);
-			arr = (T*) ::operator new (sizeof(T) * arrSize);
-		}
-		dataSize = other.dataSize;
-		for (int i = 0; i < other.dataSize; ++i)
-			memcpy(&arr[i], &other.arr[i], sizeof(T));
+		destroy(0);
+		append(other);
 		return *this;
 	}
 	/**
@@ -321,17 +661,16 @@ public:
 	 * throw index_out_of_bound() if pos is not in [0, size)
 	 * !!! Pay attentions
 	 *   In STL this operator does not check the boundary but I want you to do.
+	 * the check is decided by Access, unchecked_access removes it.
 	 */
 	T & operator[](const size_t &pos)
 	{
-		if (pos < 0 || pos >= dataSize)
-			throw index_out_of_bound();
+		Access::check(pos, dataSize);
 		return arr[pos];
 	}
 	const T & operator[](const size_t &pos) const
 	{
-		if (pos < 0 || pos >= dataSize)
-			throw index_out_of_bound();
+		Access::check(pos, dataSize);
 		return arr[pos];
 	}
 	/**
@@ -354,27 +693,38 @@ public:
 			throw container_is_empty();
 		return arr[dataSize - 1];
 	}
+	/**
+	 * returns a pointer to the underlying successive storage.
+	 */
+	T * data()
+	{
+		return arr;
+	}
+	const T * data() const
+	{
+		return arr;
+	}
 	/**
 	 * returns an iterator to the beginning.
 	 */
 	iterator begin()
 	{
-		return iterator(this, 0);
+		return iterator(this, arr);
 	}
 	const_iterator cbegin() const
 	{
-		return const_iterator(this, 0);
+		return const_iterator(this, arr);
 	}
 	/**
 	 * returns an iterator to the end.
 	 */
 	iterator end()
 	{
-		return iterator(this, dataSize);
+		return iterator(this, arr + dataSize);
 	}
 	const_iterator cend() const
 	{
-		return const_iterator(this, dataSize);
+		return const_iterator(this, arr + dataSize);
 	}
 	/**
 	 * checks whether the container is empty
@@ -397,12 +747,78 @@ public:
 	{
 		return arrSize;
 	}
+	/**
+	 * increase the capacity to at least n, never shrinks.
+	 */
+	void reserve(const size_t &n)
+	{
+		if (n > arrSize)
+			reallocate(n);
+	}
+	/**
+	 * reduce the capacity to size() (at least 1).
+	 * a small_vector moves its elements back to the inline storage if they fit.
+	 */
+	void shrink_to_fit()
+	{
+		if (arr == this->inline_data())
+			return;
+		if (N > 0 && dataSize <= N)
+		{
+			adopt(this->inline_data(), N);
+			return;
+		}
+		size_t cap = dataSize == 0 ? 1 : dataSize;
+		if (cap < arrSize)
+			reallocate(cap);
+	}
+	/**
+	 * resize the container to contain n elements.
+	 * new elements are copies of value (or default constructed).
+	 */
+	void resize(const size_t &n, const T &value)
+	{
+		if (n <= dataSize)
+		{
+			destroy(n);
+			return;
+		}
+		reserve(n);
+		for (; dataSize < n; ++dataSize)
+			new(&arr[dataSize]) T(value);
+	}
+	void resize(const size_t &n)
+	{
+		if (n <= dataSize)
+		{
+			destroy(n);
+			return;
+		}
+		reserve(n);
+		for (; dataSize < n; ++dataSize)
+			new(&arr[dataSize]) T();
+	}
+	/**
+	 * returns the counters of reallocations, bytes moved by reallocations
+	 *   and the peak capacity of this vector.
+	 */
+	const statistics & stats() const
+	{
+		return counter;
+	}
+	/**
+	 * returns the allocator of the storage.
+	 */
+	Allocator get_allocator() const
+	{
+		return alloc;
+	}
 	/**
 	 * clears the contents
 	 */
 	void clear()
 	{
-		dataSize = 0;
+		destroy(0);
 	}
 	/**
 	 * inserts value before pos
@@ -410,15 +826,11 @@ public:
 	 */
 	iterator insert(iterator pos, const T &value)
 	{
-		if (pos.vec != this)
-			throw invalid_iterator();
-		if (dataSize + 1 == arrSize)
-			expand();
-		for (int i = dataSize; i > pos.index; --i)
-			memcpy(&arr[i], &arr[i - 1], sizeof(T));
-		++dataSize;
-		new(&arr[pos.index]) T(value);
-		return iterator(this, pos.index);
+		return emplace(pos, value);
+	}
+	iterator insert(iterator pos, T &&value)
+	{
+		return emplace(pos, std::move(value));
 	}
 	/**
 	 * inserts value at index ind.
@@ -430,13 +842,73 @@ public:
 	{
 		if (ind < 0 || ind > dataSize)
 			throw index_out_of_bound();
-		if (dataSize + 1 == arrSize)
-			expand();
-		for (int i = dataSize; i > ind; --i)
-			memcpy(&arr[i], &arr[i - 1], sizeof(T));
-		++dataSize;
-		new(&arr[ind]) T(value);
-		return iterator(this, ind);
+		emplace_at(ind, value);
+		return iterator(this, arr + ind);
+	}
+	iterator insert(const size_t &ind, T &&value)
+	{
+		if (ind < 0 || ind > dataSize)
+			throw index_out_of_bound();
+		emplace_at(ind, std::move(value));
+		return iterator(this, arr + ind);
+	}
+	/**
+	 * constructs an element in place before pos, args are forwarded to the constructor of T.
+	 * returns an iterator pointing to the new element.
+	 */
+	template<class... Args>
+	iterator emplace(iterator pos, Args&&... args)
+	{
+		if (pos.vec != this)
+			throw invalid_iterator();
+		size_t ind = pos.ptr - arr;
+		emplace_at(ind, std::forward<Args>(args)...);
+		return iterator(this, arr + ind);
+	}
+	/**
+	 * inserts count copies of value before pos, the tail is moved only once.
+	 * returns an iterator pointing to the first inserted value (or pos if count == 0).
+	 */
+	iterator insert(iterator pos, const size_t &count, const T &value)
+	{
+		if (pos.vec != this)
+			throw invalid_iterator();
+		if (count == 0)
+			return pos;
+		if (&value >= arr && &value < arr + dataSize)
+		{
+			T tmp(value);
+			return insert(pos, count, tmp);
+		}
+		size_t ind = pos.ptr - arr;
+		open_gap(ind, count);
+		for (size_t i = 0; i < count; ++i)
+			new(&arr[ind + i]) T(value);
+		dataSize += count;
+		return iterator(this, arr + ind);
+	}
+	/**
+	 * inserts the elements in [first, last) before pos, the tail is moved only once.
+	 * [first, last) should not be a range of this vector.
+	 * returns an iterator pointing to the first inserted value (or pos if first == last).
+	 */
+	template<class InputIt, class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+	iterator insert(iterator pos, InputIt first, InputIt last)
+	{
+		if (pos.vec != this)
+			throw invalid_iterator();
+		size_t count = 0;
+		for (InputIt i = first; i != last; ++i)
+			++count;
+		if (count == 0)
+			return pos;
+		size_t ind = pos.ptr - arr;
+		open_gap(ind, count);
+		T *cur = arr + ind;
+		for (; first != last; ++first, ++cur)
+			new(cur) T(*first);
+		dataSize += count;
+		return iterator(this, arr + ind);
 	}
 	/**
 	 * removes the element at pos.
@@ -447,11 +919,26 @@ public:
 	{
 		if (pos.vec != this)
 			throw invalid_iterator();
-		arr[pos.index].~T();
-		for (int i = pos.index; i < dataSize - 1; ++i)
-			memcpy(&arr[i], &arr[i + 1], sizeof(T));
+		pos.ptr->~T();
+		relocate(pos.ptr, pos.ptr + 1, arr + dataSize - pos.ptr - 1);
 		--dataSize;
-		return iterator(this, pos.index);
+		return pos;
+	}
+	/**
+	 * removes the elements in [first, last), the tail is moved only once.
+	 * return an iterator pointing to the element following the removed ones.
+	 */
+	iterator erase(iterator first, iterator last)
+	{
+		if (first.vec != this || last.vec != this || first.ptr > last.ptr)
+			throw invalid_iterator();
+		if (first.ptr == last.ptr)
+			return first;
+		for (T *i = first.ptr; i != last.ptr; ++i)
+			i->~T();
+		relocate(first.ptr, last.ptr, arr + dataSize - last.ptr);
+		dataSize -= last.ptr - first.ptr;
+		return first;
 	}
 	/**
 	 * removes the element with index ind.
@@ -463,20 +950,28 @@ public:
 		if (ind >= dataSize)
 			throw index_out_of_bound();
 		arr[ind].~T();
-		for (int i = ind; i < dataSize - 1; ++i)
-			memcpy(&arr[i], &arr[i + 1], sizeof(T));
+		relocate(arr + ind, arr + ind + 1, dataSize - ind - 1);
 		--dataSize;
-		return iterator(this, ind);
+		return iterator(this, arr + ind);
 	}
 	/**
 	 * adds an element to the end.
 	 */
 	void push_back(const T &value)
 	{
-		if (dataSize + 1 == arrSize)
-			expand();
-		new(&arr[dataSize]) T(value);
-		++dataSize;
+		emplace_at(dataSize, value);
+	}
+	void push_back(T &&value)
+	{
+		emplace_at(dataSize, std::move(value));
+	}
+	/**
+	 * constructs an element in place at the end.
+	 */
+	template<class... Args>
+	void emplace_back(Args&&... args)
+	{
+		emplace_at(dataSize, std::forward<Args>(args)...);
 	}
 	/**
 	 * remove the last element from the end.
@@ -486,12 +981,20 @@ public:
 	{
 		if (empty())
 			throw container_is_empty();
-		arr[dataSize].~T();
 		--dataSize;
+		arr[dataSize].~T();
 	}
 };
 
 
+/**
+ * a vector which stores up to N elements inline and only allocates after that.
+ * it has the same interface, iterators and exceptions as vector.
+ */
+template<typename T, size_t N, class Allocator = std::allocator<T>, class Growth = double_growth, class Access = checked_access>
+using small_vector = vector<T, Allocator, Growth, Access, N>;
+
+
 }
 
 #endif